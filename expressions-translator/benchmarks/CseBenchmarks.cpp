@@ -0,0 +1,158 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "Generator.h"
+#include "Translation.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+struct Totals {
+  double translateMs{};
+  std::size_t rustBytes{};
+  std::size_t temporaries{};
+  double compileMs{};
+  double runMs{};
+};
+
+std::size_t count(const std::string &text, const std::string &pattern) {
+  std::size_t result = 0;
+  for (auto at = text.find(pattern); at != std::string::npos;
+       at = text.find(pattern, at + 1)) {
+    ++result;
+  }
+  return result;
+}
+
+std::string readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+// Compiles rust code and runs it, returns its output.
+std::string compileAndRun(const std::string &code, const std::string &base,
+                          Totals &totals) {
+  std::ofstream(base + ".rs") << code;
+
+  // Generated programs overflow, constant propagation must not reject them.
+  auto start = Clock::now();
+  const auto compile = "rustc -O -A warnings -A arithmetic_overflow "
+                       "-A unconditional_panic -o " +
+                       base + ' ' + base + ".rs";
+  if (std::system(compile.c_str()) != 0) {
+    std::cerr << "rustc failed on " << base << ".rs\n";
+    std::exit(EXIT_FAILURE);
+  }
+  totals.compileMs += millisecondsSince(start);
+
+  start = Clock::now();
+  if (std::system((base + " > " + base + ".out").c_str()) != 0) {
+    std::cerr << base << " failed\n";
+    std::exit(EXIT_FAILURE);
+  }
+  totals.runMs += millisecondsSince(start);
+  return readFile(base + ".out");
+}
+
+void report(const std::string &name, const Totals &totals, bool run) {
+  std::cout << std::setw(8) << name << std::fixed << std::setprecision(2)
+            << std::setw(14) << totals.translateMs << std::setw(12)
+            << totals.rustBytes << std::setw(14) << totals.temporaries;
+  if (run) {
+    std::cout << std::setw(14) << totals.compileMs << std::setw(12)
+              << totals.runMs;
+  }
+  std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  benchmarks::GeneratorOptions options;
+  options.typed = true;
+  options.repeats = 30;
+  std::size_t programs = 10;
+  std::size_t size = 64 * 1024;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = std::stoull(arg.substr(arg.find('=') + 1));
+    if (arg.rfind("--seed=", 0) == 0) {
+      options.seed = value;
+    } else if (arg.rfind("--programs=", 0) == 0) {
+      programs = value;
+    } else if (arg.rfind("--size=", 0) == 0) {
+      size = value;
+    } else if (arg.rfind("--repeats=", 0) == 0) {
+      options.repeats = value;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--seed=N] [--programs=N] [--size=BYTES] [--repeats=N]\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  const bool run = std::system("rustc --version > /dev/null 2>&1") == 0;
+  if (!run) {
+    std::cerr << "rustc not found, generated programs are not run\n";
+  }
+
+  const auto base = "/tmp/CseBenchmarks_" + std::to_string(::getpid());
+  translator::Translator translate;
+  Totals plain, cse;
+  std::ostringstream diagnostics;
+  for (std::size_t i = 0; i < programs; ++i, ++options.seed) {
+    const auto source = benchmarks::ProgramGenerator(options).generateSize(size);
+    std::string outputs[2];
+    for (bool eliminate : {false, true}) {
+      auto &totals = eliminate ? cse : plain;
+      translator::Options translation;
+      translation.cse = eliminate;
+
+      const auto start = Clock::now();
+      auto code = translate(source, {}, translation, diagnostics);
+      totals.translateMs += millisecondsSince(start);
+      if (!code) {
+        std::cerr << "Generated program failed to translate\n"
+                  << diagnostics.str();
+        return EXIT_FAILURE;
+      }
+      totals.rustBytes += code->size();
+      totals.temporaries += count(*code, "let __cse");
+      if (run) {
+        outputs[eliminate] = compileAndRun(*code, base, totals);
+      }
+    }
+
+    if (outputs[0] != outputs[1]) {
+      std::cerr << "Output differs with common subexpression elimination, seed "
+                << options.seed << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+  for (auto suffix : {"", ".rs", ".out"}) {
+    std::remove((base + suffix).c_str());
+  }
+
+  std::cout << std::setw(8) << "mode" << std::setw(14) << "translate ms"
+            << std::setw(12) << "rust bytes" << std::setw(14) << "temporaries";
+  if (run) {
+    std::cout << std::setw(14) << "compile ms" << std::setw(12) << "run ms";
+  }
+  std::cout << '\n';
+  report("plain", plain, run);
+  report("cse", cse, run);
+}
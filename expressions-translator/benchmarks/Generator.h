@@ -0,0 +1,224 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace benchmarks {
+
+struct GeneratorOptions {
+  std::uint64_t seed{42};
+  // Number of top-level statements, used by `generate()`.
+  std::size_t statements{100};
+  // Maximum depth of operator nesting in expressions.
+  std::size_t expressionDepth{4};
+  // Maximum depth of `if` statements nesting.
+  std::size_t ifNesting{2};
+  // Percentage of expressions repeating one of the recently generated ones.
+  std::size_t repeats{0};
+  // Generates programs whose translations rustc accepts: integer arithmetic
+  // without division and powers, comparisons only in `if` conditions.
+  bool typed{false};
+};
+
+// Seeded generator of valid book programs. Every used variable is declared by
+// a `let` first and `if` blocks are always braced.
+class ProgramGenerator {
+public:
+  explicit ProgramGenerator(GeneratorOptions options)
+      : options(options), random(options.seed) {}
+
+  std::string generate() {
+    std::string program;
+    for (std::size_t i = 0; i < options.statements; ++i) {
+      statement(program, 0);
+    }
+    return program;
+  }
+
+  // Generates top-level statements until program is at least `bytes` long.
+  std::string generateSize(std::size_t bytes) {
+    std::string program;
+    program.reserve(bytes + 1024);
+    while (program.size() < bytes) {
+      statement(program, 0);
+    }
+    return program;
+  }
+
+private:
+  std::size_t pick(std::size_t bound) {
+    return std::uniform_int_distribution<std::size_t>(0, bound - 1)(random);
+  }
+
+  void statement(std::string &out, std::size_t nesting) {
+    const bool topLevel = nesting == 0;
+    if (variables.empty() || (topLevel && pick(8) == 0)) {
+      auto name = "v" + std::to_string(variables.size());
+      out += "let " + name + " = ";
+      expression(out, options.expressionDepth);
+      out += '\n';
+      variables.push_back(std::move(name));
+      return;
+    }
+
+    switch (pick(nesting < options.ifNesting ? 5 : 4)) {
+    case 0:
+      out += variables[pick(variables.size())] + " = ";
+      expression(out, options.expressionDepth);
+      break;
+    case 1:
+      out += "print ";
+      expression(out, options.expressionDepth);
+      break;
+    case 2:
+      out += "println ";
+      expression(out, options.expressionDepth);
+      break;
+    case 3:
+      // `==` right after a statement ending with identifier reads as `ID =`
+      expression(out, options.expressionDepth, true);
+      break;
+    default:
+      out += "if ";
+      if (options.typed) {
+        condition(out, options.expressionDepth);
+      } else {
+        expression(out, options.expressionDepth);
+      }
+      block(out, nesting + 1);
+      // Statement right after `if` block is read as its `else` block, typed
+      // programs keep variables declared by it in scope.
+      if (options.typed || pick(2) == 0) {
+        out += " else";
+        block(out, nesting + 1);
+      }
+      break;
+    }
+    out += '\n';
+  }
+
+  void block(std::string &out, std::size_t nesting) {
+    out += " {\n";
+    for (std::size_t i = 0, count = 1 + pick(3); i < count; ++i) {
+      statement(out, nesting);
+    }
+    out += '}';
+  }
+
+  void expression(std::string &out, std::size_t depth,
+                  bool statement = false) {
+    if (options.typed) {
+      integer(out, depth);
+      return;
+    }
+    if (!statement && repeat(out, depth)) {
+      return;
+    }
+
+    // Shifts are left out: as nested operands they are ambiguous with
+    // comparisons in the book grammar.
+    static const char *const binary[] = {"+", "-",  "*",  "/", "&",  "|", "==",
+                                         "!=", ">", "<", ">=", "<=", "^"};
+    static const char *const unary[] = {"!", "~", "n"};
+
+    const auto start = out.size();
+    const auto choice = depth == 0 ? 0 : pick(4);
+    if (choice == 0) {
+      atom(out);
+    } else if (choice == 1) {
+      out += unary[pick(std::size(unary))];
+      out += ' ';
+      expression(out, depth - 1);
+    } else {
+      const std::string op = binary[pick(std::size(binary))];
+      out += statement && op == "==" ? "!=" : op;
+      out += ' ';
+      expression(out, depth - 1);
+      out += ' ';
+      expression(out, depth - 1);
+    }
+    remember(out, start, depth);
+  }
+
+  void integer(std::string &out, std::size_t depth) {
+    if (repeat(out, depth)) {
+      return;
+    }
+
+    static const char *const binary[] = {"+", "-", "*"};
+    static const char *const unary[] = {"!", "~", "n"};
+
+    const auto start = out.size();
+    const auto choice = depth == 0 ? 0 : pick(4);
+    if (choice == 0) {
+      atom(out);
+    } else if (choice == 1) {
+      out += unary[pick(std::size(unary))];
+      out += ' ';
+      integer(out, depth - 1);
+    } else {
+      out += binary[pick(std::size(binary))];
+      out += ' ';
+      integer(out, depth - 1);
+      out += ' ';
+      integer(out, depth - 1);
+    }
+    remember(out, start, depth);
+  }
+
+  void condition(std::string &out, std::size_t depth) {
+    static const char *const comparisons[] = {"==", "!=", ">", "<", ">=", "<="};
+
+    if (depth > 1 && pick(4) == 0) {
+      out += pick(2) == 0 ? "& " : "| ";
+      condition(out, depth - 1);
+      out += ' ';
+      condition(out, depth - 1);
+      return;
+    }
+
+    out += comparisons[pick(std::size(comparisons))];
+    out += ' ';
+    integer(out, depth == 0 ? 0 : depth - 1);
+    out += ' ';
+    integer(out, depth == 0 ? 0 : depth - 1);
+  }
+
+  void atom(std::string &out) {
+    if (!variables.empty() && pick(2) == 0) {
+      out += variables[pick(variables.size())];
+    } else {
+      out += std::to_string(pick(100));
+    }
+  }
+
+  // Appends one of the recently generated expressions, if it is time to.
+  bool repeat(std::string &out, std::size_t depth) {
+    if (depth == 0 || recent.empty() || pick(100) >= options.repeats) {
+      return false;
+    }
+    out += recent[pick(recent.size())];
+    return true;
+  }
+
+  void remember(const std::string &out, std::size_t start, std::size_t depth) {
+    if (options.repeats == 0 || depth == 0) {
+      return;
+    }
+    if (recent.size() < 16) {
+      recent.push_back(out.substr(start));
+    } else {
+      recent[pick(recent.size())] = out.substr(start);
+    }
+  }
+
+  GeneratorOptions options;
+  std::mt19937_64 random;
+  std::vector<std::string> variables;
+  std::vector<std::string> recent;
+};
+
+} // namespace benchmarks
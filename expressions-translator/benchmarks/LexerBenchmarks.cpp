@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "Context.h"
+#include "Generator.h"
+#include "LexicalAnalyzer.h"
+#include "MappedFile.h"
+#include "Parser.tab.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Lexes the whole input, returns the number of tokens.
+std::size_t lex(book::LexicalAnalyzer &lexer) {
+  std::size_t tokens = 0;
+  while (lexer.get().kind() != book::Parser::symbol_kind::S_YYEOF) {
+    ++tokens;
+  }
+  return tokens;
+}
+
+// Best of `repeats` runs of `run`, in MiB/s of a `bytes` long input.
+template <typename Run>
+double throughput(std::size_t bytes, std::size_t repeats, Run run) {
+  double best = 0;
+  for (std::size_t i = 0; i < repeats; ++i) {
+    const auto start = Clock::now();
+    run();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    best = std::max(best, bytes / (1024.0 * 1024.0) / elapsed.count());
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  benchmarks::GeneratorOptions options;
+  std::size_t size = 64 * 1024 * 1024;
+  std::size_t repeats = 5;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    const auto equals = arg.find('=');
+    const auto name = arg.substr(0, equals);
+    std::size_t value = 0;
+    bool valid = equals != std::string::npos;
+    if (valid) {
+      const auto text = std::string_view(arg).substr(equals + 1);
+      const auto [end, error] =
+          std::from_chars(text.data(), text.data() + text.size(), value);
+      valid = error == std::errc() && end == text.data() + text.size();
+    }
+
+    if (valid && name == "--seed") {
+      options.seed = value;
+    } else if (valid && name == "--size") {
+      size = value;
+    } else if (valid && name == "--repeats" && value != 0) {
+      repeats = value;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--seed=N] [--size=BYTES] [--repeats=N]\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  const std::string path = "LexerBenchmarks.book";
+  const auto source = benchmarks::ProgramGenerator(options).generateSize(size);
+  std::ofstream(path, std::ios::binary) << source;
+
+  // Files were read through std::ifstream before they were mapped.
+  std::size_t streamTokens = 0;
+  const auto stream = throughput(source.size(), repeats, [&] {
+    std::ifstream in(path, std::ios::binary);
+    book::Context context;
+    book::LexicalAnalyzer lexer(&in, context);
+    streamTokens = lex(lexer);
+  });
+
+  std::size_t mappedTokens = 0;
+  const auto mapped = throughput(source.size(), repeats, [&] {
+    const book::MappedFile file(path);
+    book::Context context;
+    book::LexicalAnalyzer lexer(file.view(), context);
+    mappedTokens = lex(lexer);
+  });
+
+  std::remove(path.c_str());
+  if (streamTokens != mappedTokens) {
+    std::cerr << "Token counts differ: " << streamTokens << " from ifstream, "
+              << mappedTokens << " from mapped file\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << std::fixed << std::setprecision(2)
+            << source.size() / (1024.0 * 1024.0) << " MiB, " << mappedTokens
+            << " tokens, best of " << repeats << " runs\n"
+            << "ifstream:    " << stream << " MiB/s\n"
+            << "mapped file: " << mapped << " MiB/s\n";
+}
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Generator.h"
+#include "Server.h"
+#include "Translation.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Minimal client of the server protocol.
+class Client {
+public:
+  explicit Client(const std::string &path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof address.sun_path - 1);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    while (::connect(fd, reinterpret_cast<sockaddr *>(&address),
+                     sizeof address) != 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  ~Client() { ::close(fd); }
+
+  // Sends a request and waits for the response, returns whether it was `ok`.
+  bool translate(const std::string &source) {
+    auto request = "translate " + std::to_string(source.size()) + '\n' + source;
+    if (::write(fd, request.data(), request.size()) !=
+        static_cast<ssize_t>(request.size())) {
+      return false;
+    }
+
+    std::size_t end;
+    while ((end = buffer.find('\n')) == std::string::npos) {
+      if (!fill()) {
+        return false;
+      }
+    }
+    const auto header = std::string_view(buffer).substr(0, end);
+    const auto space = header.find(' ');
+    std::size_t length;
+    if (space == std::string_view::npos ||
+        !translator::parseNumber(header.substr(space + 1), length)) {
+      return false;
+    }
+    const auto ok = header.substr(0, space) == "ok";
+    while (buffer.size() - end - 1 < length) {
+      if (!fill()) {
+        return false;
+      }
+    }
+    buffer.erase(0, end + 1 + length);
+    return ok;
+  }
+
+private:
+  // Appends what the server has sent so far to `buffer`.
+  bool fill() {
+    char chunk[64 * 1024];
+    auto count = ::read(fd, chunk, sizeof chunk);
+    if (count <= 0) {
+      return false;
+    }
+    buffer.append(chunk, count);
+    return true;
+  }
+
+  int fd;
+  std::string buffer;
+};
+
+struct Latencies {
+  std::vector<double> microseconds;
+  double seconds{};
+
+  double percentile(double p) {
+    std::sort(microseconds.begin(), microseconds.end());
+    return microseconds[static_cast<std::size_t>(p * (microseconds.size() - 1))];
+  }
+};
+
+void report(const std::string &name, Latencies latencies) {
+  std::cout << std::setw(24) << name << std::fixed << std::setprecision(1)
+            << std::setw(12) << latencies.percentile(0.5) << std::setw(12)
+            << latencies.percentile(0.99) << std::setw(14)
+            << latencies.microseconds.size() / latencies.seconds << std::endl;
+}
+
+template <typename Translate>
+Latencies measure(const std::vector<std::string> &sources, std::size_t clients,
+                  Translate translate) {
+  Latencies result;
+  std::vector<std::vector<double>> perClient(clients);
+  std::vector<std::thread> threads;
+
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < clients; ++i) {
+    threads.emplace_back([&, i] {
+      for (auto &&source : sources) {
+        const auto requestStart = Clock::now();
+        if (!translate(i, source)) {
+          std::cerr << "Generated snippet failed to translate\n";
+          std::exit(EXIT_FAILURE);
+        }
+        perClient[i].push_back(std::chrono::duration<double, std::micro>(
+                                   Clock::now() - requestStart)
+                                   .count());
+      }
+    });
+  }
+  for (auto &&thread : threads) {
+    thread.join();
+  }
+  result.seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  for (auto &&latencies : perClient) {
+    result.microseconds.insert(result.microseconds.end(), latencies.begin(),
+                               latencies.end());
+  }
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  benchmarks::GeneratorOptions options;
+  options.statements = 10;
+  std::size_t requests = 10000;
+  std::size_t maxClients = 8;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    const auto equals = arg.find('=');
+    const auto name = arg.substr(0, equals);
+    std::size_t value = 0;
+    const bool valid =
+        equals != std::string::npos &&
+        translator::parseNumber(std::string_view(arg).substr(equals + 1), value);
+
+    if (valid && name == "--seed") {
+      options.seed = value;
+    } else if (valid && name == "--statements") {
+      options.statements = value;
+    } else if (valid && name == "--requests" && value != 0) {
+      requests = value;
+    } else if (valid && name == "--clients" && value != 0) {
+      maxClients = value;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--seed=N] [--statements=N] [--requests=N] [--clients=N]\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<std::string> sources;
+  for (std::size_t i = 0; i < requests; ++i) {
+    options.seed += 1;
+    sources.push_back(benchmarks::ProgramGenerator(options).generate());
+  }
+
+  std::cout << std::setw(24) << "mode" << std::setw(12) << "p50 us"
+            << std::setw(12) << "p99 us" << std::setw(14) << "requests/s"
+            << '\n';
+
+  std::ostringstream diagnostics;
+  report("translate()", measure(sources, 1, [&](std::size_t,
+                                                const std::string &source) {
+           return translator::translate(source, {}, {}, diagnostics)
+               .has_value();
+         }));
+
+  translator::Translator reused;
+  report("reused Translator", measure(sources, 1, [&](std::size_t,
+                                                      const std::string &source) {
+           return reused(source, {}, {}, diagnostics).has_value();
+         }));
+
+  const std::string path =
+      "/tmp/ServerBenchmarks." + std::to_string(::getpid()) + ".sock";
+  translator::Server server({}, maxClients);
+  std::thread listener([&] {
+    if (!server.listen(path)) {
+      std::perror("listen");
+      std::exit(EXIT_FAILURE);
+    }
+  });
+
+  for (std::size_t clients = 1; clients <= maxClients; clients *= 2) {
+    std::vector<std::unique_ptr<Client>> connections;
+    for (std::size_t i = 0; i < clients; ++i) {
+      connections.push_back(std::make_unique<Client>(path));
+    }
+    report("server, " + std::to_string(clients) + " clients",
+           measure(sources, clients,
+                   [&](std::size_t client, const std::string &source) {
+                     return connections[client]->translate(source);
+                   }));
+  }
+
+  server.stop();
+  listener.join();
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <sys/resource.h>
+
+#include "Context.h"
+#include "Generator.h"
+#include "LexicalAnalyzer.h"
+#include "Parser.tab.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+double peakRssMiB() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;
+}
+
+struct Measurement {
+  std::size_t tokens{};
+  double lexMs{};
+  double parseMs{};
+  double emitMs{};
+  double writeMs{};
+  std::size_t outputBytes{};
+};
+
+Measurement measure(const std::string &source, const std::string &outputPath) {
+  Measurement result;
+
+  {
+    book::Context context;
+    book::LexicalAnalyzer lexer(std::string_view(source), context);
+    const auto start = Clock::now();
+    while (lexer.get().kind() != book::Parser::symbol_kind::S_YYEOF) {
+      ++result.tokens;
+    }
+    result.lexMs = millisecondsSince(start);
+  }
+
+  // Emission runs in the parser's final action, statistics time it apart.
+  // Lexing is timed again there, so its timer overhead is subtracted too.
+  book::Stats stats;
+  book::Context context;
+  context.setStats(&stats);
+  book::LexicalAnalyzer lexer(std::string_view(source), context);
+  book::Parser parser(context, lexer);
+  auto start = Clock::now();
+  if (parser() != 0 || !context.getResult()) {
+    std::cerr << "Generated program failed to translate\n";
+    std::exit(EXIT_FAILURE);
+  }
+  const auto parseRun = stats.lexTime + stats.emitTime;
+  result.parseMs = std::max(
+      0.0, millisecondsSince(start) -
+               std::chrono::duration<double, std::milli>(parseRun).count());
+  result.emitMs =
+      std::chrono::duration<double, std::milli>(stats.emitTime).count();
+
+  start = Clock::now();
+  {
+    std::ofstream out(outputPath, std::ios::binary);
+    out << *context.getResult();
+  }
+  result.writeMs = millisecondsSince(start);
+  result.outputBytes = context.getResult()->size();
+  return result;
+}
+
+std::string formatSize(std::size_t bytes) {
+  static const char *const units[] = {"B", "KiB", "MiB", "GiB"};
+  std::size_t unit = 0;
+  while (bytes >= 1024 && unit + 1 < std::size(units)) {
+    bytes /= 1024;
+    ++unit;
+  }
+  return std::to_string(bytes) + ' ' + units[unit];
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  benchmarks::GeneratorOptions options;
+  std::size_t maxSize = std::size_t{1} << 30;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    const auto equals = arg.find('=');
+    const auto name = arg.substr(0, equals);
+    std::size_t value = 0;
+    bool valid = equals != std::string::npos;
+    if (valid) {
+      const auto text = std::string_view(arg).substr(equals + 1);
+      const auto [end, error] =
+          std::from_chars(text.data(), text.data() + text.size(), value);
+      valid = error == std::errc() && end == text.data() + text.size();
+    }
+
+    if (valid && name == "--seed") {
+      options.seed = value;
+    } else if (valid && name == "--max-size") {
+      maxSize = value;
+    } else if (valid && name == "--depth") {
+      options.expressionDepth = value;
+    } else if (valid && name == "--nesting") {
+      options.ifNesting = value;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--seed=N] [--max-size=BYTES] [--depth=N] [--nesting=N]\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  const std::string outputPath = "TranslatorBenchmarks.out.rs";
+  std::cout << std::setw(10) << "size" << std::setw(12) << "tokens"
+            << std::setw(12) << "lex ms" << std::setw(12) << "parse ms"
+            << std::setw(12) << "emit ms" << std::setw(12) << "write ms"
+            << std::setw(12) << "MiB/s"
+            << std::setw(14) << "peak RSS MiB" << '\n';
+
+  for (std::size_t size = 1024; size <= maxSize; size *= 32) {
+    const auto source = benchmarks::ProgramGenerator(options).generateSize(size);
+    const auto result = measure(source, outputPath);
+    const double totalMs =
+        result.lexMs + result.parseMs + result.emitMs + result.writeMs;
+
+    std::cout << std::fixed << std::setprecision(2) << std::setw(10)
+              << formatSize(size) << std::setw(12) << result.tokens
+              << std::setw(12) << result.lexMs << std::setw(12)
+              << result.parseMs << std::setw(12) << result.emitMs
+              << std::setw(12) << result.writeMs << std::setw(12)
+              << source.size() / (1024.0 * 1024.0) / (totalMs / 1000.0)
+              << std::setw(14) << peakRssMiB() << std::endl;
+  }
+
+  std::remove(outputPath.c_str());
+}
@@ -1,8 +1,18 @@
 #pragma once
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_set>
+#include <vector>
 
+#include "Emitter.h"
+#include "Expression.h"
+#include "Program.h"
+#include "Stats.h"
 #include "location.hh"
 
 namespace book {
@@ -12,11 +22,26 @@ public:
   Context() = default;
   Context(std::string filename) : filename(std::move(filename)) {
     location = book::location(&*this->filename);
-    location.lines();
   }
 
-  location &getLocation() { return location; }
-  const location &getLocation() const { return location; }
+  // Prepares the context for translation of another source, keeping the
+  // settings and allocated memory.
+  void reset(std::optional<std::string> filename = {}) {
+    this->filename = std::move(filename);
+    location = book::location(this->filename ? &*this->filename : nullptr);
+    result.reset();
+    variables.clear();
+    expressions.clear();
+    program.clear();
+    offset = 0;
+    lineStarts.assign(1, 0);
+    source.reset();
+    sourceFile.close();
+    errorCount = 0;
+  }
+
+  book::location &getLocation() { return location; }
+  const book::location &getLocation() const { return location; }
 
   std::optional<std::string> getResult() const { return result; }
   void setResult(std::string result) { this->result = result; }
@@ -27,11 +52,126 @@ public:
 
   void addVariable(const std::string &name) { variables.insert(name); }
 
+  ExpressionPool &getExpressions() { return expressions; }
+  Program &getProgram() { return program; }
+
+  // Renders translated program with `main` as its top-level block.
+  std::string emit(BlockId main) const {
+    if (!stats) {
+      return book::emit(program, expressions, main, emitOptions);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto code = book::emit(program, expressions, main, emitOptions);
+    stats->emitTime += std::chrono::steady_clock::now() - start;
+    return code;
+  }
+
+  const EmitOptions &getEmitOptions() const { return emitOptions; }
+  void setEmitOptions(const EmitOptions &options) { emitOptions = options; }
+
+public: /* Source lines index */
+  // Called by the lexer for every matched lexeme.
+  void advance(std::size_t length) { offset += length; }
+
+  // Called by the lexer after `count` newlines were matched as the last
+  // lexeme, records the offsets at which the following lines start.
+  void newLines(std::size_t count) {
+    for (std::size_t i = count; i > 0; --i) {
+      lineStarts.push_back(offset - i + 1);
+    }
+  }
+
+  // In-memory source, if set, snippets are taken from it instead of the file.
+  // Source must outlive the context.
+  void setSource(std::string_view source) { this->source = source; }
+
+  // Returns text of the 1-based source line, if it was already reached by
+  // the lexer and the source is available.
+  std::optional<std::string> getSourceLine(int line) {
+    if (line < 1 || static_cast<std::size_t>(line) > lineStarts.size()) {
+      return {};
+    }
+
+    const auto start = lineStarts[line - 1];
+    if (source) {
+      if (start > source->size()) {
+        return {};
+      }
+      auto text = source->substr(start);
+      return std::string(text.substr(0, text.find('\n')));
+    }
+
+    if (!filename) {
+      return {};
+    }
+    if (!sourceFile.is_open()) {
+      sourceFile.open(*filename);
+    }
+
+    std::string text;
+    sourceFile.clear();
+    sourceFile.seekg(start);
+    if (!std::getline(sourceFile, text)) {
+      return {};
+    }
+    return text;
+  }
+
+public: /* Statistics */
+  // Statistics collected during translation, disabled if null.
+  Stats *getStats() const { return stats; }
+  void setStats(Stats *stats) { this->stats = stats; }
+
+  // Called by the lexer for every token carrying a string semantic value.
+  void countTokenValue(std::size_t bytes) {
+    if (stats) {
+      stats->semanticValueBytes += bytes;
+    }
+  }
+
+  // Called once the parser finished, counts the built program.
+  void countProgramValues() {
+    if (stats) {
+      stats->semanticValueBytes += expressions.bytes() + program.bytes();
+    }
+  }
+
+public: /* Errors */
+  // Stream diagnostics are reported to, standard error by default.
+  std::ostream &getDiagnostics() const { return *diagnostics; }
+  void setDiagnostics(std::ostream &stream) { diagnostics = &stream; }
+
+  std::size_t getErrorCount() const { return errorCount; }
+  void addError() { ++errorCount; }
+
+  // Limit of reported errors after which translation stops, 0 means no limit.
+  std::size_t getErrorLimit() const { return errorLimit; }
+  void setErrorLimit(std::size_t limit) { errorLimit = limit; }
+
+  bool errorLimitReached() const {
+    return errorLimit != 0 && errorCount >= errorLimit;
+  }
+
 private:
-  location location{};
+  book::location location{};
   std::optional<std::string> filename;
   std::optional<std::string> result;
   std::unordered_set<std::string> variables;
+  ExpressionPool expressions;
+  Program program;
+  EmitOptions emitOptions;
+
+  std::size_t offset{};
+  std::vector<std::size_t> lineStarts{0};
+  std::optional<std::string_view> source;
+  std::ifstream sourceFile;
+
+  Stats *stats{};
+
+  std::ostream *diagnostics{&std::cerr};
+  std::size_t errorCount{};
+  std::size_t errorLimit{20};
 };
 
-} // namespace book
\ No newline at end of file
+} // namespace book
@@ -0,0 +1,486 @@
+#include "Emitter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace book {
+
+namespace {
+
+constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+
+bool isIdentifier(std::string_view text) {
+  return !text.empty() && !std::isdigit(static_cast<unsigned char>(text[0]));
+}
+
+// Finds subexpressions worth computing once. Every expression node is a
+// single occurrence in the source. Structurally equal nodes share a value
+// number, and every assignment of a variable gets a new stamp, so
+// occurrences with equal number and equal latest stamp of their variables
+// compute the same value. Such occurrences are grouped behind the first
+// one, the leader. The leader must be evaluated unconditionally (not in the
+// right operand of `&&` or `||`) and the others must be in its block or the
+// blocks nested in it. Groups that still have two occurrences after larger
+// groups were replaced get a temporary, defined right before the statement
+// of the leader.
+class CommonSubexpressions {
+public:
+  CommonSubexpressions(const Program &program,
+                       const ExpressionPool &expressions, BlockId main)
+      : program(program), expressions(expressions),
+        valueNumbers(expressions.size()), sizes(expressions.size()),
+        groupOf(expressions.size(), NONE),
+        conditional(expressions.size()), stamps(expressions.size()),
+        dead(expressions.size()), open(program.blockCount()),
+        statementDefinitions(program.statementCount()) {
+    number();
+    walk(main);
+    choose();
+  }
+
+  // Group of the hoisted temporary computing the node, or NONE.
+  std::size_t temporary(ExprId id) const {
+    auto group = groupOf[id];
+    return group != NONE && groups[group].hoisted && !dead[id] ? group : NONE;
+  }
+
+  // Groups whose temporaries are defined before the statement, in
+  // evaluation order.
+  const std::vector<std::size_t> &definitions(StatementId statement) const {
+    return statementDefinitions[statement];
+  }
+
+  ExprId leader(std::size_t group) const { return groups[group].leader; }
+
+  std::size_t groupCount() const { return groups.size(); }
+
+  // Prefix of temporary names not clashing with any variable.
+  const std::string &prefix() const { return namePrefix; }
+
+private:
+  struct Group {
+    ExprId leader;
+    StatementId statement;
+    BlockId block;
+    std::vector<ExprId> members;
+    bool hoisted{};
+  };
+
+  struct Key {
+    std::size_t valueNumber;
+    std::size_t stamp;
+
+    bool operator==(const Key &other) const {
+      return valueNumber == other.valueNumber && stamp == other.stamp;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key &key) const {
+      return key.valueNumber * 0x9e3779b97f4a7c15ULL ^ key.stamp;
+    }
+  };
+
+  // Operands are created before their operators, so a single pass in
+  // creation order numbers every node after its operands. Nodes of one
+  // expression are contiguous and end with its root.
+  void number() {
+    std::unordered_map<std::string, std::size_t> numbers;
+    std::string key;
+    for (ExprId id = 0; id < expressions.size(); ++id) {
+      const auto kind = expressions.kind(id);
+      key.assign(1, static_cast<char>(kind));
+      if (kind == ExpressionPool::Kind::Atom) {
+        key += expressions.text(id);
+        sizes[id] = 1;
+      } else {
+        if (auto op = expressions.op(id)) {
+          key.append(op, std::strlen(op) + 1);
+        }
+        const auto left = expressions.left(id);
+        key.append(reinterpret_cast<const char *>(&valueNumbers[left]),
+                   sizeof(std::size_t));
+        sizes[id] = 1 + sizes[left];
+        if (kind != ExpressionPool::Kind::Unary) {
+          const auto right = expressions.right(id);
+          key.append(reinterpret_cast<const char *>(&valueNumbers[right]),
+                     sizeof(std::size_t));
+          sizes[id] += sizes[right];
+        }
+      }
+      valueNumbers[id] =
+          numbers.emplace(key, numbers.size()).first->second;
+    }
+  }
+
+  void walk(BlockId main) {
+    struct Item {
+      bool close;
+      BlockId block;
+      StatementId statement;
+    };
+    std::vector<Item> stack;
+    auto enter = [&](BlockId block) {
+      open[block] = true;
+      stack.push_back({true, block, 0});
+      const auto &statements = program.getBlock(block);
+      for (auto it = statements.rbegin(); it != statements.rend(); ++it) {
+        stack.push_back({false, block, *it});
+      }
+    };
+
+    std::vector<std::string_view> names;
+    enter(main);
+    while (!stack.empty()) {
+      auto item = stack.back();
+      stack.pop_back();
+      if (item.close) {
+        open[item.block] = false;
+        continue;
+      }
+
+      const auto &statement = program.getStatement(item.statement);
+      switch (statement.kind) {
+      case Program::Kind::Empty:
+        break;
+      case Program::Kind::Read:
+        assign(statement.name, names);
+        break;
+      case Program::Kind::Let:
+      case Program::Kind::Assign:
+        occurrences(statement.expression, item.statement, item.block, names);
+        assign(statement.name, names);
+        break;
+      case Program::Kind::If:
+        occurrences(statement.expression, item.statement, item.block, names);
+        if (statement.otherwise != NO_BLOCK) {
+          enter(statement.otherwise);
+        }
+        enter(statement.then);
+        break;
+      default:
+        occurrences(statement.expression, item.statement, item.block, names);
+        break;
+      }
+    }
+
+    namePrefix = "__cse";
+    while (std::any_of(names.begin(), names.end(), [&](auto name) {
+      return name.substr(0, namePrefix.size()) == namePrefix;
+    })) {
+      namePrefix += '_';
+    }
+  }
+
+  void assign(std::string_view name, std::vector<std::string_view> &names) {
+    variableStamps[name] = ++clock;
+    names.push_back(name);
+  }
+
+  void occurrences(ExprId root, StatementId statement, BlockId block,
+                   std::vector<std::string_view> &names) {
+    const auto first = root + 1 - sizes[root];
+
+    conditional[root] = false;
+    for (auto id = root + 1; id-- > first;) {
+      const auto kind = expressions.kind(id);
+      if (kind == ExpressionPool::Kind::Atom) {
+        continue;
+      }
+      conditional[expressions.left(id)] = conditional[id];
+      if (kind != ExpressionPool::Kind::Unary) {
+        const auto op = expressions.op(id);
+        const bool shortCircuit =
+            op && (std::strcmp(op, "&&") == 0 || std::strcmp(op, "||") == 0);
+        conditional[expressions.right(id)] = conditional[id] || shortCircuit;
+      }
+    }
+
+    for (auto id = first; id <= root; ++id) {
+      const auto kind = expressions.kind(id);
+      if (kind == ExpressionPool::Kind::Atom) {
+        const auto text = expressions.text(id);
+        stamps[id] = 0;
+        if (isIdentifier(text)) {
+          names.push_back(text);
+          auto stamp = variableStamps.find(text);
+          stamps[id] = stamp != variableStamps.end() ? stamp->second : 0;
+        }
+        continue;
+      }
+
+      stamps[id] = stamps[expressions.left(id)];
+      if (kind != ExpressionPool::Kind::Unary) {
+        stamps[id] = std::max(stamps[id], stamps[expressions.right(id)]);
+      }
+
+      auto latest =
+          latestGroups.try_emplace(Key{valueNumbers[id], stamps[id]}, NONE)
+              .first;
+      if (latest->second != NONE && open[groups[latest->second].block]) {
+        groupOf[id] = latest->second;
+        groups[latest->second].members.push_back(id);
+      } else if (!conditional[id]) {
+        latest->second = groups.size();
+        groupOf[id] = groups.size();
+        groups.push_back({id, statement, block, {id}});
+      }
+    }
+  }
+
+  // Larger expressions first, so that occurrences replaced by their
+  // temporaries no longer count for their subexpressions.
+  void choose() {
+    std::vector<std::size_t> candidates;
+    for (std::size_t group = 0; group < groups.size(); ++group) {
+      if (groups[group].members.size() >= 2) {
+        candidates.push_back(group);
+      }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&](auto a, auto b) {
+                       return sizes[groups[a].leader] > sizes[groups[b].leader];
+                     });
+
+    for (auto index : candidates) {
+      auto &group = groups[index];
+      if (dead[group.leader]) {
+        continue;
+      }
+      auto live = std::count_if(group.members.begin(), group.members.end(),
+                                [&](auto id) { return !dead[id]; });
+      if (live < 2) {
+        continue;
+      }
+
+      group.hoisted = true;
+      statementDefinitions[group.statement].push_back(index);
+      for (auto member : group.members) {
+        if (member != group.leader && !dead[member]) {
+          std::fill(dead.begin() + (member + 1 - sizes[member]),
+                    dead.begin() + member, true);
+        }
+      }
+    }
+
+    for (auto &definitions : statementDefinitions) {
+      std::sort(definitions.begin(), definitions.end(), [&](auto a, auto b) {
+        return groups[a].leader < groups[b].leader;
+      });
+    }
+  }
+
+  const Program &program;
+  const ExpressionPool &expressions;
+
+  std::vector<std::size_t> valueNumbers;
+  std::vector<std::size_t> sizes;
+  std::vector<std::size_t> groupOf;
+  std::vector<bool> conditional;
+  std::vector<std::size_t> stamps;
+  std::vector<bool> dead;
+  std::vector<bool> open;
+
+  std::size_t clock{};
+  std::unordered_map<std::string_view, std::size_t> variableStamps;
+  std::unordered_map<Key, std::size_t, KeyHash> latestGroups;
+  std::vector<Group> groups;
+  std::vector<std::vector<std::size_t>> statementDefinitions;
+  std::string namePrefix;
+};
+
+class Emitter {
+public:
+  Emitter(const Program &program, const ExpressionPool &expressions,
+          const CommonSubexpressions *cse)
+      : program(program), expressions(expressions), cse(cse),
+        temporaryNames(cse ? cse->groupCount() : 0) {
+    std::string prefix = "__book";
+    for (StatementId id = 0; id < program.statementCount(); ++id) {
+      const auto &statement = program.getStatement(id);
+      reads |= statement.kind == Program::Kind::Read;
+      writes |= statement.kind == Program::Kind::Print ||
+                statement.kind == Program::Kind::Println;
+      while (statement.name.compare(0, prefix.size(), prefix) == 0) {
+        prefix += '_';
+      }
+    }
+    input = prefix + "_in";
+    output = prefix + "_out";
+    line = prefix + "_line";
+  }
+
+  std::string emit(BlockId main) {
+    prelude();
+    pushBlock(main, 1);
+    while (!stack.empty()) {
+      auto item = stack.back();
+      stack.pop_back();
+      if (item.text) {
+        indent(item.level);
+        out += item.text;
+      } else {
+        statement(item.statement, item.level);
+      }
+    }
+    if (writes) {
+      out += "  " + output + ".flush().unwrap();\n";
+    }
+    out += "}\n";
+    return std::move(out);
+  }
+
+private:
+  struct Item {
+    const char *text;
+    StatementId statement;
+    std::size_t level;
+  };
+
+  void pushBlock(BlockId block, std::size_t level) {
+    const auto &statements = program.getBlock(block);
+    for (auto it = statements.rbegin(); it != statements.rend(); ++it) {
+      stack.push_back({nullptr, *it, level});
+    }
+  }
+
+  void indent(std::size_t level) { out.append(level * 2, ' '); }
+
+  // Programs doing I/O lock standard streams once and buffer the output,
+  // instead of locking and possibly flushing on every statement.
+  void prelude() {
+    if (reads && writes) {
+      out = "use std::io::{BufRead, Write};\n\n";
+    } else if (reads || writes) {
+      out = reads ? "use std::io::BufRead;\n\n" : "use std::io::Write;\n\n";
+    }
+
+    out += "fn main() {\n";
+    if (reads) {
+      out += "  let mut " + input + " = std::io::stdin().lock();\n";
+      out += "  let mut " + line + " = String::new();\n";
+    }
+    if (writes) {
+      out += "  let mut " + output +
+             " = std::io::BufWriter::new(std::io::stdout().lock());\n";
+    }
+  }
+
+  void expression(ExprId id, ExprId defined = NONE) {
+    if (!cse) {
+      expressions.print(id, out);
+      return;
+    }
+    expressions.print(id, out, [&](ExprId node, std::string &text) {
+      auto group = cse->temporary(node);
+      if (group == NONE || node == defined) {
+        return false;
+      }
+      text += temporaryNames[group];
+      return true;
+    });
+  }
+
+  void statement(StatementId id, std::size_t level) {
+    const auto &statement = program.getStatement(id);
+    if (cse) {
+      for (auto group : cse->definitions(id)) {
+        temporaryNames[group] =
+            cse->prefix() + std::to_string(temporaryCount++);
+        indent(level);
+        out += "let " + temporaryNames[group] + " = ";
+        expression(cse->leader(group), cse->leader(group));
+        out += ";\n";
+      }
+    }
+
+    if (statement.kind == Program::Kind::Empty) {
+      return;
+    }
+    indent(level);
+    switch (statement.kind) {
+    case Program::Kind::Empty:
+      break;
+    case Program::Kind::Expression:
+      expression(statement.expression);
+      out += ";\n";
+      break;
+    case Program::Kind::Let:
+      out += "let mut " + statement.name + " = ";
+      expression(statement.expression);
+      out += ";\n";
+      break;
+    case Program::Kind::Assign:
+      out += statement.name + " = ";
+      expression(statement.expression);
+      out += ";\n";
+      break;
+    case Program::Kind::Print:
+    case Program::Kind::Println:
+      out += statement.kind == Program::Kind::Print ? "write!(" : "writeln!(";
+      out += output + ", \"{}\", ";
+      expression(statement.expression);
+      out += ").unwrap();\n";
+      break;
+    case Program::Kind::Read:
+      // Prompts printed so far must be visible before waiting for input
+      if (writes) {
+        out += output + ".flush().unwrap();\n";
+        indent(level);
+      }
+      out += line + ".clear();\n";
+      indent(level);
+      out += input + ".read_line(&mut " + line + ").unwrap();\n";
+      indent(level);
+      // Integer literals default to i32 too
+      out += "let mut " + statement.name + ": i32 = " + line +
+             ".trim().parse().unwrap();\n";
+      break;
+    case Program::Kind::If:
+      out += "if ";
+      expression(statement.expression);
+      out += " {\n";
+      stack.push_back({"}\n", 0, level});
+      if (statement.otherwise != NO_BLOCK) {
+        pushBlock(statement.otherwise, level + 1);
+        stack.push_back({"} else {\n", 0, level});
+      }
+      pushBlock(statement.then, level + 1);
+      break;
+    }
+  }
+
+  const Program &program;
+  const ExpressionPool &expressions;
+  const CommonSubexpressions *cse;
+
+  bool reads{};
+  bool writes{};
+  std::string input;
+  std::string output;
+  std::string line;
+
+  std::string out;
+  std::vector<Item> stack;
+  std::vector<std::string> temporaryNames;
+  std::size_t temporaryCount{};
+};
+
+} // namespace
+
+std::string emit(const Program &program, const ExpressionPool &expressions,
+                 BlockId main, const EmitOptions &options) {
+  std::optional<CommonSubexpressions> cse;
+  if (options.eliminateCommonSubexpressions) {
+    cse.emplace(program, expressions, main);
+  }
+  return Emitter(program, expressions, cse ? &*cse : nullptr).emit(main);
+}
+
+} // namespace book
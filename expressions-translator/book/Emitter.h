@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+
+#include "Expression.h"
+#include "Program.h"
+
+namespace book {
+
+// Revision of the emitted code, part of translation cache keys. Bump it
+// whenever the same program and options start to translate differently
+// (2: `if` statements end with a newline, 3: buffered standard streams).
+constexpr unsigned OUTPUT_REVISION = 3;
+
+struct EmitOptions {
+  // Computes repeated pure subexpressions once into `let` temporaries.
+  bool eliminateCommonSubexpressions{};
+};
+
+// Renders `main` block of the program as rust `main` function.
+std::string emit(const Program &program, const ExpressionPool &expressions,
+                 BlockId main, const EmitOptions &options = {});
+
+} // namespace book
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace book {
+
+using ExprId = std::size_t;
+
+// Expression trees of a translation unit. Nodes live in one flat pool and
+// are printed with an explicit stack, so arbitrarily deep expressions are
+// built, printed and freed in linear time without recursion.
+class ExpressionPool {
+public:
+  ExprId atom(std::string_view text) {
+    nodes.push_back({Kind::Atom, nullptr, atoms.size(), text.size()});
+    atoms += text;
+    return nodes.size() - 1;
+  }
+
+  // `op` must be a string literal.
+  ExprId binary(ExprId left, const char *op, ExprId right) {
+    nodes.push_back({Kind::Binary, op, left, right});
+    return nodes.size() - 1;
+  }
+
+  ExprId power(ExprId base, ExprId exponent) {
+    nodes.push_back({Kind::Power, nullptr, base, exponent});
+    return nodes.size() - 1;
+  }
+
+  // `op` must be a string literal.
+  ExprId unary(const char *op, ExprId operand) {
+    nodes.push_back({Kind::Unary, op, operand, 0});
+    return nodes.size() - 1;
+  }
+
+  // Appends rust code of the expression to `out`.
+  void print(ExprId id, std::string &out) const {
+    print(id, out, [](ExprId, std::string &) { return false; });
+  }
+
+  // Same as above, but `substitute(id, out)` is asked first for every node
+  // and may append its own code for it instead, returning true.
+  template <typename Substitute>
+  void print(ExprId id, std::string &out, Substitute substitute) const {
+    struct Item {
+      const char *literal;
+      ExprId node;
+    };
+    std::vector<Item> stack{{nullptr, id}};
+
+    while (!stack.empty()) {
+      auto item = stack.back();
+      stack.pop_back();
+      if (item.literal) {
+        out += item.literal;
+        continue;
+      }
+      if (substitute(item.node, out)) {
+        continue;
+      }
+
+      const auto &node = nodes[item.node];
+      switch (node.kind) {
+      case Kind::Atom:
+        out.append(atoms, node.left, node.right);
+        break;
+      case Kind::Binary:
+        stack.insert(stack.end(), {{")", 0},
+                                   {nullptr, node.right},
+                                   {" ", 0},
+                                   {node.op, 0},
+                                   {" ", 0},
+                                   {nullptr, node.left}});
+        out += '(';
+        break;
+      case Kind::Power:
+        stack.insert(stack.end(), {{")", 0},
+                                   {nullptr, node.right},
+                                   {".pow(", 0},
+                                   {nullptr, node.left}});
+        break;
+      case Kind::Unary:
+        stack.push_back({nullptr, node.left});
+        out += node.op;
+        break;
+      }
+    }
+  }
+
+  std::string print(ExprId id) const {
+    std::string out;
+    print(id, out);
+    return out;
+  }
+
+  void clear() {
+    nodes.clear();
+    atoms.clear();
+  }
+
+  // Bytes of nodes and atom texts created since the last `clear`.
+  std::size_t bytes() const {
+    return nodes.size() * sizeof(Node) + atoms.size();
+  }
+
+public: /* Nodes, operands are always created before their operators */
+  enum class Kind { Atom, Binary, Power, Unary };
+
+  std::size_t size() const { return nodes.size(); }
+  Kind kind(ExprId id) const { return nodes[id].kind; }
+  // Operator of binary and unary nodes.
+  const char *op(ExprId id) const { return nodes[id].op; }
+  // Left operand, base of power or the only operand of unary node.
+  ExprId left(ExprId id) const { return nodes[id].left; }
+  ExprId right(ExprId id) const { return nodes[id].right; }
+  std::string_view text(ExprId id) const {
+    return std::string_view(atoms).substr(nodes[id].left, nodes[id].right);
+  }
+
+private:
+  // Atoms keep offset and length of their text in `atoms` as left and right.
+  struct Node {
+    Kind kind;
+    const char *op;
+    std::size_t left;
+    std::size_t right;
+  };
+
+  std::vector<Node> nodes;
+  std::string atoms;
+};
+
+} // namespace book
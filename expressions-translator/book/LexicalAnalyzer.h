@@ -8,6 +8,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
 namespace book {
 
 class LexicalAnalyzer : public yyFlexLexer {
@@ -15,13 +20,40 @@ public: /* Constructor and destructor */
   LexicalAnalyzer(std::istream *in, class Context &context)
       : yyFlexLexer(in), context(context){};
 
+  // Scans in-memory source (e.g. mapped file) bypassing istream, so the
+  // source is copied once into flex's buffer instead of twice through the
+  // stream buffer. Source must outlive the analyzer.
+  LexicalAnalyzer(std::string_view source, class Context &context)
+      : yyFlexLexer(nullptr), context(context), source(source){};
+
   virtual ~LexicalAnalyzer() = default;
 
 public: /* Public API */
   Parser::symbol_type get();
 
+  // Restarts scanning with another in-memory source, reusing the buffers.
+  void reset(std::string_view source) {
+    this->source = source;
+    yyrestart(yyin);
+  }
+
+protected: /* Flex input */
+  // C++ scanners only read through this, flex's own buffer cannot point into
+  // the source.
+  int LexerInput(char *buf, int max_size) override {
+    if (!source) {
+      return yyFlexLexer::LexerInput(buf, max_size);
+    }
+
+    auto size = std::min(source->size(), static_cast<std::size_t>(max_size));
+    std::memcpy(buf, source->data(), size);
+    source->remove_prefix(size);
+    return static_cast<int>(size);
+  }
+
 private: /* Data */
   Context &context;
+  std::optional<std::string_view> source;
 };
 
-} // namespace book
\ No newline at end of file
+} // namespace book
@@ -0,0 +1,61 @@
+#pragma once
+#include <cerrno>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace book {
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), path);
+    }
+
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+      int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), path);
+    }
+
+    size = static_cast<std::size_t>(info.st_size);
+    if (size != 0) {
+      data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), path);
+      }
+      ::madvise(data, size, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile() {
+    if (size != 0) {
+      ::munmap(data, size);
+    }
+  }
+
+  std::string_view view() const {
+    return {static_cast<const char *>(data), size};
+  }
+
+private:
+  void *data{};
+  std::size_t size{};
+};
+
+} // namespace book
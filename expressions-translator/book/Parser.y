@@ -8,11 +8,16 @@
 %parse-param {class Context &context}
 %parse-param {class LexicalAnalyzer &lexer}
 
+%code requires {
+#include "Expression.h"
+#include "Program.h"
+}
+
 %code {
 #include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <chrono>
 #include <string>
-#include <sstream>
 
 #include "Context.h"
 #include "LexicalAnalyzer.h"
@@ -20,28 +25,35 @@
 using namespace std;
 
 #undef yylex
-#define yylex lexer.get
-
-static std::string binaryOp(const std::string& left, const std::string& op, const std::string& right) {
-  return "(" + left + " " + op + " " + right  + ")";
-}
-
-static std::string makeIf(const std::string& cond, const std::string& ifBlock, const std::string& elseBlock = "") {
-  return "if " + cond + " " + ifBlock + (elseBlock.empty() ? "" : " else " + elseBlock);
-}
-
-static std::string indent(const std::string& code, int level) {
-  std::string result;
-  std::string indentation(level * 2, ' ');
-  std::string line;
-  std::istringstream stream(code);
-  
-  while (std::getline(stream, line)) {
-    if (!line.empty()) {
-      result += indentation + line + "\n";
-    }
+#define yylex() lex(lexer, context)
+
+// Counts reductions for statistics, then computes location as default does.
+#define YYLLOC_DEFAULT(Current, Rhs, N)                                  \
+  do {                                                                   \
+    if (auto stats = context.getStats()) {                               \
+      ++stats->reductions;                                               \
+      stats->maxStackDepth = std::max(stats->maxStackDepth,              \
+                                      std::size_t(yystack_.size()));     \
+    }                                                                    \
+    if (N) {                                                             \
+      (Current).begin = YYRHSLOC(Rhs, 1).begin;                          \
+      (Current).end = YYRHSLOC(Rhs, N).end;                              \
+    } else {                                                             \
+      (Current).begin = (Current).end = YYRHSLOC(Rhs, 0).end;            \
+    }                                                                    \
+  } while (false)
+
+static book::Parser::symbol_type lex(book::LexicalAnalyzer &lexer, book::Context &context) {
+  auto stats = context.getStats();
+  if (!stats) {
+    return lexer.get();
   }
-  return result;
+
+  const auto start = std::chrono::steady_clock::now();
+  auto token = lexer.get();
+  stats->lexTime += std::chrono::steady_clock::now() - start;
+  ++stats->tokens;
+  return token;
 }
 }
 
@@ -50,100 +62,106 @@ static std::string indent(const std::string& code, int level) {
 %token               LET IF ELSE PRINT PRINTLN READ
 %token               END 0 "end of file"
 
-%type <std::string> start program stmt_list stmt expr primary code_block
+// Blocks, statements and expressions are indices into the program and the
+// expression pool of the context.
+%type <std::size_t> program stmt_list code_block stmt expr primary
 
 %%
-start: program                   { context.setResult($1); }
+start: program                   { if (context.getErrorCount() != 0) YYABORT;
+                                   context.setResult(context.emit($1)); }
    ;
 
 program:
-  stmt_list                      { $$ = "fn main() {\n" + indent($1, 1) + "}\n"; }
+  stmt_list                      { $$ = $1; }
   ;
 
 stmt_list:
-  stmt                           { $$ = $1; }
-  | stmt_list stmt               { $$ = $1 + $2; }
+  stmt                           { $$ = context.getProgram().block();
+                                   context.getProgram().append($$, $1); }
+  | stmt_list stmt               { $$ = $1; context.getProgram().append($$, $2); }
   ;
 
 code_block:
-  stmt                           { $$ = "{\n" + indent($1, 1) + "}"; }
-  | '{' stmt_list '}'            { $$ = "{\n" + indent($2, 1) + "}"; }
+  stmt                           { $$ = context.getProgram().block();
+                                   context.getProgram().append($$, $1); }
+  | '{' stmt_list '}'            { $$ = $2; }
   ;
 
 stmt:
-  expr                           { $$ = $1 + ";\n"; }
+  expr                           { $$ = context.getProgram().statement(Program::Kind::Expression, {}, $1); }
   | LET ID '=' expr              { context.addVariable($2);
-                                   $$ = "let mut " + $2 + " = " + $4 + ";\n"; }
-  | ID '=' expr                  { $$ = $1 + " = " + $3 + ";\n"; }
-  | PRINT expr                   { $$ = "print!(\"{}\", " + $2 + ");\n"; }
-  | PRINTLN expr                 { $$ = "println!(\"{}\", " + $2 + ");\n"; }
-  | ID '=' READ                  { $$ = "let mut line = String::new();\n"
-                                   "std::io::stdin().read_line(&mut line).unwrap();\n"
-                                   "let mut " + $1 + " = line.trim().parse().unwrap();\n"; }
-  | IF expr code_block           { $$ = makeIf($2, $3); }
+                                   $$ = context.getProgram().statement(Program::Kind::Let, $2, $4); }
+  | ID '=' expr                  { $$ = context.getProgram().statement(Program::Kind::Assign, $1, $3); }
+  | PRINT expr                   { $$ = context.getProgram().statement(Program::Kind::Print, {}, $2); }
+  | PRINTLN expr                 { $$ = context.getProgram().statement(Program::Kind::Println, {}, $2); }
+  | ID '=' READ                  { context.addVariable($1);
+                                   $$ = context.getProgram().statement(Program::Kind::Read, $1); }
+  | IF expr code_block           { $$ = context.getProgram().statement(Program::Kind::If, {}, $2, $3); }
   | IF expr code_block
-            code_block           { $$ = makeIf($2, $3, $4); }
+            code_block           { $$ = context.getProgram().statement(Program::Kind::If, {}, $2, $3, $4); }
   | IF expr code_block
-    ELSE code_block              { $$ = makeIf($2, $3, $5); }
+    ELSE code_block              { $$ = context.getProgram().statement(Program::Kind::If, {}, $2, $3, $5); }
+  | error                        { if (context.errorLimitReached()) YYABORT;
+                                   $$ = context.getProgram().statement(Program::Kind::Empty); }
   ;
 
 expr: 
   primary                        { $$ = $1; }
-  | '+' expr expr                { $$ = binaryOp($2, "+", $3); }
-  | '-' expr expr                { $$ = binaryOp($2, "-", $3); }
-  | '*' expr expr                { $$ = binaryOp($2, "*", $3); }
-  | '/' expr expr                { $$ = binaryOp($2, "/", $3); }
-  | '&' expr expr                { $$ = binaryOp($2, "&&", $3); }
-  | '|' expr expr                { $$ = binaryOp($2, "||", $3); }
-  | '=''=' expr expr             { $$ = binaryOp($3, "==", $4); }
-  | '!''=' expr expr             { $$ = binaryOp($3, "!=", $4); }
-  | '>' expr expr                { $$ = binaryOp($2, ">", $3); }
-  | '<' expr expr                { $$ = binaryOp($2, "<", $3); }
-  | '>''=' expr expr             { $$ = binaryOp($3, ">=", $4); }
-  | '<''=' expr expr             { $$ = binaryOp($3, "<=", $4); }
-  | '<''<' expr expr             { $$ = binaryOp($3, "<<", $4); }
-  | '>''>' expr expr             { $$ = binaryOp($3, ">>", $4); }
-  | '>''>''>' expr expr          { $$ = binaryOp($4, ">>>", $5); }
-  | '^' expr expr                { $$ = $2 + ".pow(" + $3 + ")"; }
-  | '!' expr                     { $$ = "!" + $2; }
-  | '~' expr                     { $$ = "!" + $2; }
-  | 'n' expr                     { $$ = "-" + $2; }
+  | '+' expr expr                { $$ = context.getExpressions().binary($2, "+", $3); }
+  | '-' expr expr                { $$ = context.getExpressions().binary($2, "-", $3); }
+  | '*' expr expr                { $$ = context.getExpressions().binary($2, "*", $3); }
+  | '/' expr expr                { $$ = context.getExpressions().binary($2, "/", $3); }
+  | '&' expr expr                { $$ = context.getExpressions().binary($2, "&&", $3); }
+  | '|' expr expr                { $$ = context.getExpressions().binary($2, "||", $3); }
+  | '=''=' expr expr             { $$ = context.getExpressions().binary($3, "==", $4); }
+  | '!''=' expr expr             { $$ = context.getExpressions().binary($3, "!=", $4); }
+  | '>' expr expr                { $$ = context.getExpressions().binary($2, ">", $3); }
+  | '<' expr expr                { $$ = context.getExpressions().binary($2, "<", $3); }
+  | '>''=' expr expr             { $$ = context.getExpressions().binary($3, ">=", $4); }
+  | '<''=' expr expr             { $$ = context.getExpressions().binary($3, "<=", $4); }
+  | '<''<' expr expr             { $$ = context.getExpressions().binary($3, "<<", $4); }
+  | '>''>' expr expr             { $$ = context.getExpressions().binary($3, ">>", $4); }
+  | '>''>''>' expr expr          { $$ = context.getExpressions().binary($4, ">>>", $5); }
+  | '^' expr expr                { $$ = context.getExpressions().power($2, $3); }
+  | '!' expr                     { $$ = context.getExpressions().unary("!", $2); }
+  | '~' expr                     { $$ = context.getExpressions().unary("!", $2); }
+  | 'n' expr                     { $$ = context.getExpressions().unary("-", $2); }
   ;
 
 primary:
-  NUM                            { $$ = $1; }
-  | ID                           { if (!context.hasVariable($1)) error(@1, "Undefined variable: " + $1);
-                                   $$ = $1; }
+  NUM                            { $$ = context.getExpressions().atom($1); }
+  | ID                           { if (!context.hasVariable($1)) {
+                                     error(@1, "Undefined variable: " + $1);
+                                     if (context.errorLimitReached()) YYABORT;
+                                   }
+                                   $$ = context.getExpressions().atom($1); }
   ;
 %%
 
 void book::Parser::error(const location &loc, const std::string &message) {
-  std::cerr << loc << ": error: " << message << '\n';
+  context.addError();
+  auto &diagnostics = context.getDiagnostics();
+  diagnostics << loc << ": error: " << message << '\n';
 
-  if (!loc.begin.filename) {
-    return;
-  }
-  std::ifstream sourceFile(*loc.begin.filename);
-  std::string line;
-  for (int lineNum = 1; lineNum < loc.end.line; ++lineNum) {
-    if (!std::getline(sourceFile, line)) {
+  for (int lineNum = loc.begin.line; lineNum <= loc.end.line; ++lineNum) {
+    auto line = context.getSourceLine(lineNum);
+    if (!line) {
       break;
     }
 
-    if (lineNum >= loc.begin.line - 1) {
-      std::cerr << "    " << line << '\n';
-      
-      if (lineNum == loc.begin.line - 1) {
-        const int indent = loc.begin.column - 1;
-        const int length = (lineNum == loc.end.line - 1) 
-            ? loc.end.column - loc.begin.column - 1
-            : line.length() - indent - 1;
-        std::cerr 
-            << "    "  << std::string(indent, ' ') 
-            << '^' << std::string(length, '~') << '\n';
-      }
+    diagnostics << "    " << *line << '\n';
+    if (lineNum == loc.begin.line) {
+      const int indent = loc.begin.column - 1;
+      const int length = (lineNum == loc.end.line)
+          ? loc.end.column - loc.begin.column - 1
+          : line->length() - indent - 1;
+      diagnostics
+          << "    "  << std::string(indent, ' ')
+          << '^' << std::string(std::max(length, 0), '~') << '\n';
     }
   }
 
-  exit(1);
-}
\ No newline at end of file
+  if (context.errorLimitReached()) {
+    diagnostics << "error limit reached, stopping translation\n";
+  }
+}
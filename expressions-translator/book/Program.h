@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Expression.h"
+
+namespace book {
+
+using StatementId = std::size_t;
+using BlockId = std::size_t;
+
+constexpr BlockId NO_BLOCK = static_cast<BlockId>(-1);
+
+// Statements and blocks of a translation unit, their expressions are kept in
+// an ExpressionPool.
+class Program {
+public:
+  enum class Kind { Empty, Expression, Let, Assign, Print, Println, Read, If };
+
+  struct Statement {
+    Kind kind;
+    // Variable of `let`, assignment and `read`.
+    std::string name;
+    // Expression, assigned value or condition of `if`.
+    ExprId expression;
+    BlockId then;
+    BlockId otherwise;
+  };
+
+  StatementId statement(Kind kind, std::string name = {}, ExprId expression = 0,
+                        BlockId then = NO_BLOCK, BlockId otherwise = NO_BLOCK) {
+    statements.push_back({kind, std::move(name), expression, then, otherwise});
+    return statements.size() - 1;
+  }
+
+  BlockId block() {
+    blocks.emplace_back();
+    return blocks.size() - 1;
+  }
+
+  void append(BlockId block, StatementId statement) {
+    blocks[block].push_back(statement);
+  }
+
+  const Statement &getStatement(StatementId id) const { return statements[id]; }
+  const std::vector<StatementId> &getBlock(BlockId id) const {
+    return blocks[id];
+  }
+
+  std::size_t statementCount() const { return statements.size(); }
+  std::size_t blockCount() const { return blocks.size(); }
+
+  void clear() {
+    statements.clear();
+    blocks.clear();
+  }
+
+  // Bytes of statements, their variable names and block entries created
+  // since the last `clear`.
+  std::size_t bytes() const {
+    std::size_t total = statements.size() * sizeof(Statement);
+    for (auto &&statement : statements) {
+      total += statement.name.size();
+    }
+    for (auto &&block : blocks) {
+      total += sizeof(block) + block.size() * sizeof(StatementId);
+    }
+    return total;
+  }
+
+private:
+  std::vector<Statement> statements;
+  std::vector<std::vector<StatementId>> blocks;
+};
+
+} // namespace book
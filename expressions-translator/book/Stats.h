@@ -0,0 +1,38 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+namespace book {
+
+// Translation statistics, collected only when attached to a Context.
+struct Stats {
+  using Duration = std::chrono::steady_clock::duration;
+
+  Duration lexTime{};
+  // Whole parser run, lexing and emission included.
+  Duration parseTime{};
+  Duration emitTime{};
+  Duration writeTime{};
+
+  std::size_t tokens{};
+  std::size_t reductions{};
+  std::size_t maxStackDepth{};
+  // Bytes of semantic values: text of ID and NUM tokens, expression and
+  // statement nodes built by the parser.
+  std::size_t semanticValueBytes{};
+
+  Stats &operator+=(const Stats &other) {
+    lexTime += other.lexTime;
+    parseTime += other.parseTime;
+    emitTime += other.emitTime;
+    writeTime += other.writeTime;
+    tokens += other.tokens;
+    reductions += other.reductions;
+    maxStackDepth = std::max(maxStackDepth, other.maxStackDepth);
+    semanticValueBytes += other.semanticValueBytes;
+    return *this;
+  }
+};
+
+} // namespace book
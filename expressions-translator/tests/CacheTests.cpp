@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "Cache.h"
+#include "Translation.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path makeCacheDirectory(const std::string &name) {
+  auto directory = fs::path(testing::TempDir()) / name;
+  fs::remove_all(directory);
+  return directory;
+}
+
+} // namespace
+
+TEST(Cache, Hash) {
+  EXPECT_EQ(translator::xxh64(""), 0xef46db3751d8e999ULL);
+  EXPECT_EQ(translator::xxh64("abc"), 0x44bc2cf5ad770999ULL);
+  EXPECT_EQ(translator::xxh64("Nobody inspects the spammish repetition"),
+            0xfbcea83c8a378bf1ULL);
+  EXPECT_EQ(translator::xxh64(std::string(100, 'x'), 7), 0xae5ad321e4fe6127ULL);
+}
+
+TEST(Cache, Key) {
+  EXPECT_EQ(translator::Cache::key("print 1", ""),
+            translator::Cache::key("print 1", ""));
+  EXPECT_NE(translator::Cache::key("print 1", ""),
+            translator::Cache::key("print 2", ""));
+  EXPECT_NE(translator::Cache::key("print 1", ""),
+            translator::Cache::key("print 1", "option"));
+}
+
+TEST(Cache, StoreAndLoad) {
+  translator::Cache cache(makeCacheDirectory("store"), 1024);
+  const auto key = translator::Cache::key("print 1", "");
+
+  EXPECT_FALSE(cache.load(key));
+  cache.store(key, "value");
+  EXPECT_EQ(cache.load(key), "value");
+  EXPECT_EQ(cache.getHits(), 1);
+  EXPECT_EQ(cache.getMisses(), 1);
+}
+
+TEST(Cache, Trim) {
+  const auto directory = makeCacheDirectory("trim");
+  translator::Cache cache(directory, 250);
+  const auto now = fs::file_time_type::clock::now();
+  for (int i = 0; i < 5; ++i) {
+    auto key = translator::Cache::key(std::to_string(i), "");
+    cache.store(key, std::string(100, 'x'));
+    fs::last_write_time(directory / (key + ".rs"), now - std::chrono::hours(i));
+  }
+
+  cache.trim();
+  EXPECT_TRUE(cache.load(translator::Cache::key("0", "")));
+  EXPECT_TRUE(cache.load(translator::Cache::key("1", "")));
+  EXPECT_FALSE(cache.load(translator::Cache::key("2", "")));
+  EXPECT_FALSE(cache.load(translator::Cache::key("4", "")));
+}
+
+TEST(Cache, PeriodicTrim) {
+  const auto directory = makeCacheDirectory("periodic");
+  translator::Cache cache(directory, 1000);
+  for (std::size_t i = 0; i < translator::Cache::TRIM_INTERVAL; ++i) {
+    cache.store(translator::Cache::key(std::to_string(i), ""),
+                std::string(100, 'x'));
+  }
+
+  std::uintmax_t size = 0;
+  for (auto &&file : fs::directory_iterator(directory)) {
+    size += file.file_size();
+  }
+  EXPECT_LE(size, 1000);
+}
+
+TEST(Cache, StaleTemporaryFiles) {
+  const auto directory = makeCacheDirectory("temporary");
+  translator::Cache cache(directory, 1024);
+  const auto stale = directory / "0123456789abcdef.rs.tmp.1.2.3";
+  const auto fresh = directory / "0123456789abcdef.rs.tmp.1.2.4";
+  std::ofstream(stale) << "fn main() {";
+  std::ofstream(fresh) << "fn main() {";
+  fs::last_write_time(stale,
+                      fs::file_time_type::clock::now() - std::chrono::hours(1));
+
+  cache.trim();
+  EXPECT_FALSE(fs::exists(stale));
+  EXPECT_TRUE(fs::exists(fresh));
+}
+
+TEST(Cache, Translation) {
+  translator::Cache cache(makeCacheDirectory("translation"), 1024 * 1024);
+  translator::Options options;
+  options.cache = &cache;
+  std::ostringstream diagnostics;
+
+  auto first = translator::translate("println 42", {}, options, diagnostics);
+  auto second = translator::translate("println 42", {}, options, diagnostics);
+  ASSERT_TRUE(first);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(cache.getHits(), 1);
+
+  EXPECT_FALSE(translator::translate("print x", {}, options, diagnostics));
+  EXPECT_FALSE(translator::translate("print x", {}, options, diagnostics));
+  EXPECT_EQ(cache.getHits(), 1);
+}
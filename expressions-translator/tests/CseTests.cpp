@@ -0,0 +1,151 @@
+#include "common.h"
+
+namespace {
+
+void checkCse(const std::string &input, const std::string &expected,
+              const std::string &header = "fn main() {\n") {
+  auto context = book::Context{};
+  context.setEmitOptions({true});
+  auto stream = std::make_unique<std::istringstream>(input);
+  auto lexer = book::LexicalAnalyzer(stream.get(), context);
+  auto parser = book::Parser(context, lexer);
+
+  ASSERT_EQ(parser(), 0);
+  ASSERT_TRUE(context.getResult());
+  EXPECT_EQ(*context.getResult(), header + expected + "}\n");
+}
+
+} // namespace
+
+TEST(Cse, RepeatedSubexpression) {
+  checkCse("let x = 2 let p = * ^ x 2 ^ x 2",
+           "  let mut x = 2;\n"
+           "  let __cse0 = x.pow(2);\n"
+           "  let mut p = (__cse0 * __cse0);\n");
+}
+
+TEST(Cse, SingleOccurrenceUnchanged) {
+  checkCse("let x = 2 let p = + x 1 let p = - x 1",
+           "  let mut x = 2;\n"
+           "  let mut p = (x + 1);\n"
+           "  let mut p = (x - 1);\n");
+}
+
+TEST(Cse, LargestSubexpressionFirst) {
+  checkCse("let a = 1 let b = 2 "
+           "let p = + * a b 1 let p = + * a b 1 let p = * a b",
+           "  let mut a = 1;\n"
+           "  let mut b = 2;\n"
+           "  let __cse0 = (a * b);\n"
+           "  let __cse1 = (__cse0 + 1);\n"
+           "  let mut p = __cse1;\n"
+           "  let mut p = __cse1;\n"
+           "  let mut p = __cse0;\n");
+
+  checkCse("let a = 1 let p = + * a a 1 let p = + * a a 1",
+           "  let mut a = 1;\n"
+           "  let __cse0 = ((a * a) + 1);\n"
+           "  let mut p = __cse0;\n"
+           "  let mut p = __cse0;\n");
+}
+
+TEST(Cse, Branches) {
+  checkCse("let x = 1 "
+           "if == x 5 { let p = 1 } else { let p = 2 } if == x 5 let p = 3",
+           "  let mut x = 1;\n"
+           "  let __cse0 = (x == 5);\n"
+           "  if __cse0 {\n"
+           "    let mut p = 1;\n"
+           "  } else {\n"
+           "    let mut p = 2;\n"
+           "  }\n"
+           "  if __cse0 {\n"
+           "    let mut p = 3;\n"
+           "  }\n");
+
+  // First occurrence in a branch is not visible in the other one
+  checkCse("let x = 1 if x { let p = + x 1 } else { let p = + x 1 }",
+           "  let mut x = 1;\n"
+           "  if x {\n"
+           "    let mut p = (x + 1);\n"
+           "  } else {\n"
+           "    let mut p = (x + 1);\n"
+           "  }\n");
+
+  checkCse("let x = 1 if x { let p = + x 1 let p = + x 1 }",
+           "  let mut x = 1;\n"
+           "  if x {\n"
+           "    let __cse0 = (x + 1);\n"
+           "    let mut p = __cse0;\n"
+           "    let mut p = __cse0;\n"
+           "  }\n");
+}
+
+TEST(Cse, ShortCircuit) {
+  // Right operands of `&&` and `||` are not always evaluated
+  checkCse("let x = 1 let p = & x / 1 x let p = / 1 x",
+           "  let mut x = 1;\n"
+           "  let mut p = (x && (1 / x));\n"
+           "  let mut p = (1 / x);\n");
+
+  checkCse("let x = 1 let p = / 1 x let p = | x / 1 x",
+           "  let mut x = 1;\n"
+           "  let __cse0 = (1 / x);\n"
+           "  let mut p = __cse0;\n"
+           "  let mut p = (x || __cse0);\n");
+}
+
+TEST(Cse, Assignments) {
+  checkCse("let x = 1 let p = + x 1 x = 2 let p = + x 1",
+           "  let mut x = 1;\n"
+           "  let mut p = (x + 1);\n"
+           "  x = 2;\n"
+           "  let mut p = (x + 1);\n");
+
+  checkCse("let x = 1 x = + x 1 let p = + x 1",
+           "  let mut x = 1;\n"
+           "  x = (x + 1);\n"
+           "  let mut p = (x + 1);\n");
+
+  checkCse("let x = 1 let p = + x 1 x = read let p = + x 1",
+           "  let mut x = 1;\n"
+           "  let mut p = (x + 1);\n"
+           "  __book_line.clear();\n"
+           "  __book_in.read_line(&mut __book_line).unwrap();\n"
+           "  let mut x: i32 = __book_line.trim().parse().unwrap();\n"
+           "  let mut p = (x + 1);\n",
+           "use std::io::BufRead;\n\n"
+           "fn main() {\n"
+           "  let mut __book_in = std::io::stdin().lock();\n"
+           "  let mut __book_line = String::new();\n");
+
+  // Assignment in a branch invalidates the following uses
+  checkCse("let x = 1 let y = 2 let p = + x y "
+           "if y { x = 2 } else { let p = 0 } let p = + x y",
+           "  let mut x = 1;\n"
+           "  let mut y = 2;\n"
+           "  let mut p = (x + y);\n"
+           "  if y {\n"
+           "    x = 2;\n"
+           "  } else {\n"
+           "    let mut p = 0;\n"
+           "  }\n"
+           "  let mut p = (x + y);\n");
+
+  // Unrelated assignments do not
+  checkCse("let x = 1 let y = 2 let p = + x 1 y = 3 let p = + x 1",
+           "  let mut x = 1;\n"
+           "  let mut y = 2;\n"
+           "  let __cse0 = (x + 1);\n"
+           "  let mut p = __cse0;\n"
+           "  y = 3;\n"
+           "  let mut p = __cse0;\n");
+}
+
+TEST(Cse, TemporaryNames) {
+  checkCse("let __cse0 = 1 let p = + __cse0 1 let p = + __cse0 1",
+           "  let mut __cse0 = 1;\n"
+           "  let __cse_0 = (__cse0 + 1);\n"
+           "  let mut p = __cse_0;\n"
+           "  let mut p = __cse_0;\n");
+}
@@ -0,0 +1,76 @@
+#include "common.h"
+
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+std::size_t countErrors(const std::string &input, std::size_t limit = 0) {
+  auto context = book::Context{};
+  context.setErrorLimit(limit);
+  auto stream = std::make_unique<std::istringstream>(input);
+  auto lexer = book::LexicalAnalyzer(stream.get(), context);
+  auto parser = book::Parser(context, lexer);
+
+  EXPECT_NE(parser(), 0);
+  EXPECT_FALSE(context.getResult());
+  return context.getErrorCount();
+}
+
+} // namespace
+
+TEST(Errors, UndefinedVariables) {
+  EXPECT_EQ(countErrors("print x print y let z = 1 print z print w"), 3);
+}
+
+TEST(Errors, SyntaxErrorRecovery) {
+  EXPECT_EQ(countErrors("let = 5 print x let y = 1 print y print $"), 3);
+}
+
+TEST(Errors, ErrorLimit) {
+  EXPECT_EQ(countErrors("print a print b print c print d", 2), 2);
+  EXPECT_EQ(countErrors("print a print b print c print d", 0), 4);
+}
+
+TEST(Errors, SourceSnippet) {
+  const std::string path = testing::TempDir() + "snippet.book";
+  std::ofstream(path) << "let x = 1\n"
+                         "print + x y\n"
+                         "print z\n";
+
+  auto context = book::Context{path};
+  auto stream = std::make_unique<std::ifstream>(path);
+  auto lexer = book::LexicalAnalyzer(stream.get(), context);
+  auto parser = book::Parser(context, lexer);
+
+  testing::internal::CaptureStderr();
+  EXPECT_NE(parser(), 0);
+  auto diagnostics = testing::internal::GetCapturedStderr();
+  std::remove(path.c_str());
+
+  EXPECT_EQ(context.getErrorCount(), 2);
+  EXPECT_NE(diagnostics.find(":2.11: error: Undefined variable: y\n"
+                             "    print + x y\n"
+                             "              ^\n"),
+            std::string::npos);
+  EXPECT_NE(diagnostics.find(":3.7: error: Undefined variable: z\n"
+                             "    print z\n"
+                             "          ^\n"),
+            std::string::npos);
+}
+
+TEST(Errors, InMemorySourceSnippet) {
+  const std::string source = "let x = 1\nprint - x y\n";
+  auto context = book::Context{};
+  context.setSource(source);
+  auto lexer = book::LexicalAnalyzer(std::string_view(source), context);
+  auto parser = book::Parser(context, lexer);
+
+  testing::internal::CaptureStderr();
+  EXPECT_NE(parser(), 0);
+  auto diagnostics = testing::internal::GetCapturedStderr();
+
+  EXPECT_EQ(diagnostics, "2.11: error: Undefined variable: y\n"
+                         "    print - x y\n"
+                         "              ^\n");
+}
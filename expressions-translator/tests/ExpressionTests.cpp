@@ -52,7 +52,48 @@ TEST(ExpressionTests, ComplexExpressions) {
 }
 
 TEST(ExpressionTests, IdentifiersAndNumbers) {
-  checkExpression("+ x 5", "(x + 5)");
-  checkExpression("* y z", "(y * z)");
-  checkExpression("^ var 2", "var.pow(2)");
-}
\ No newline at end of file
+  checkExpression("let x = 1 + x 5",
+                  "fn main() {\n  let mut x = 1;\n  (x + 5);\n}\n", false);
+  checkExpression("let y = 2 let z = 3 * y z",
+                  "fn main() {\n  let mut y = 2;\n  let mut z = 3;\n"
+                  "  (y * z);\n}\n",
+                  false);
+  checkExpression("let var = 4 ^ var 2",
+                  "fn main() {\n  let mut var = 4;\n  var.pow(2);\n}\n",
+                  false);
+}
+
+TEST(ExpressionTests, DeepNesting) {
+  constexpr std::size_t depth = 1'000'000;
+  std::string input, expected;
+
+  for (std::size_t i = 0; i < depth; ++i) {
+    input += "+ ";
+  }
+  input += "1";
+  expected.append(depth, '(');
+  expected += "1";
+  for (std::size_t i = 0; i < depth; ++i) {
+    input += " 1";
+    expected += " + 1)";
+  }
+  checkExpression(input, expected);
+
+  input.clear();
+  expected.clear();
+  for (std::size_t i = 0; i < depth; ++i) {
+    input += "+ 1 ";
+    expected += "(1 + ";
+  }
+  input += "1";
+  expected += "1";
+  expected.append(depth, ')');
+  checkExpression(input, expected);
+
+  input.clear();
+  for (std::size_t i = 0; i < depth; ++i) {
+    input += "n ";
+  }
+  input += "5";
+  checkExpression(input, std::string(depth, '-') + "5");
+}
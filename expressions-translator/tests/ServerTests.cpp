@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Server.h"
+
+namespace {
+
+std::string request(const std::string &source, const std::string &options = "") {
+  return "translate " + std::to_string(source.size()) + options + "\n" + source;
+}
+
+std::string response(const std::string &status, const std::string &body) {
+  return status + " " + std::to_string(body.size()) + "\n" + body;
+}
+
+// Sends `input` to the server as one client and returns everything it
+// answered before closing the connection.
+std::string roundTrip(int fd, const std::string &input) {
+  EXPECT_EQ(::write(fd, input.data(), input.size()),
+            static_cast<ssize_t>(input.size()));
+  ::shutdown(fd, SHUT_WR);
+
+  std::string output;
+  char buffer[4096];
+  for (ssize_t count; (count = ::read(fd, buffer, sizeof buffer)) > 0;) {
+    output.append(buffer, count);
+  }
+  return output;
+}
+
+// Sends `input` as one request and reads its response, the connection is
+// kept open.
+std::string requestResponse(int fd, const std::string &input) {
+  EXPECT_EQ(::write(fd, input.data(), input.size()),
+            static_cast<ssize_t>(input.size()));
+
+  std::string output;
+  char buffer[4096];
+  for (ssize_t count; (count = ::read(fd, buffer, sizeof buffer)) > 0;) {
+    output.append(buffer, count);
+    auto header = output.find('\n');
+    if (header != std::string::npos &&
+        output.size() - header - 1 ==
+            std::stoul(output.substr(output.find(' ') + 1))) {
+      break;
+    }
+  }
+  return output;
+}
+
+int connect(const std::string &path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, path.c_str());
+  auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  while (::connect(fd, reinterpret_cast<sockaddr *>(&address),
+                   sizeof address) != 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return fd;
+}
+
+std::string serve(const std::string &input) {
+  int fds[2];
+  EXPECT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  translator::Server server({}, 1);
+  std::thread thread([&] {
+    server.serve(fds[1], fds[1]);
+    ::close(fds[1]);
+  });
+  auto output = roundTrip(fds[0], input);
+  thread.join();
+  ::close(fds[0]);
+  return output;
+}
+
+} // namespace
+
+TEST(Server, Requests) {
+  EXPECT_EQ(serve(request("+ 2 2") + request("let x = 1\n* x x")),
+            response("ok", "fn main() {\n  (2 + 2);\n}\n") +
+                response("ok", "fn main() {\n  let mut x = 1;\n"
+                               "  (x * x);\n}\n"));
+}
+
+TEST(Server, Diagnostics) {
+  EXPECT_EQ(serve(request("print a print b print c", " max-errors=2 name=a.book") +
+                  request("print y")),
+            response("error", "a.book:1.7: error: Undefined variable: a\n"
+                              "    print a print b print c\n"
+                              "          ^\n"
+                              "a.book:1.15: error: Undefined variable: b\n"
+                              "    print a print b print c\n"
+                              "                  ^\n"
+                              "error limit reached, stopping translation\n") +
+                response("error", "1.7: error: Undefined variable: y\n"
+                                  "    print y\n"
+                                  "          ^\n"));
+}
+
+TEST(Server, MalformedRequest) {
+  EXPECT_EQ(serve("translate 5 verbose\nprint 1\n" + request("print 1")),
+            response("error", "unknown option: verbose\n"));
+  EXPECT_EQ(serve("compile 5\n"),
+            response("error", "expected `translate LENGTH [OPTION...]` "
+                              "request\n"));
+}
+
+TEST(Server, TooLargeRequest) {
+  const auto length = std::to_string(translator::Server::MAX_SOURCE_SIZE + 1);
+  EXPECT_EQ(serve("translate " + length + "\nprint 1\n"),
+            response("error", "source length " + length + " exceeds " +
+                                  std::to_string(
+                                      translator::Server::MAX_SOURCE_SIZE) +
+                                  " bytes\n"));
+}
+
+TEST(Server, Socket) {
+  const std::string path = testing::TempDir() + "translator.sock";
+  translator::Server server({}, 2);
+  std::thread thread([&] { EXPECT_TRUE(server.listen(path)); });
+
+  auto first = connect(path);
+  auto second = connect(path);
+  EXPECT_EQ(roundTrip(second, request("let x = 1")),
+            response("ok", "fn main() {\n  let mut x = 1;\n}\n"));
+  EXPECT_EQ(roundTrip(first, request("- 2 1")),
+            response("ok", "fn main() {\n  (2 - 1);\n}\n"));
+  ::close(first);
+  ::close(second);
+
+  server.stop();
+  thread.join();
+}
+
+TEST(Server, MoreClientsThanJobs) {
+  const std::string path = testing::TempDir() + "translator-clients.sock";
+  translator::Server server({}, 1);
+  std::thread thread([&] { EXPECT_TRUE(server.listen(path)); });
+
+  std::vector<int> clients;
+  for (int i = 0; i < 4; ++i) {
+    clients.push_back(connect(path));
+  }
+  for (int round = 0; round < 3; ++round) {
+    for (std::size_t i = clients.size(); i-- > 0;) {
+      const auto value = std::to_string(round * 10 + i);
+      EXPECT_EQ(requestResponse(clients[i], request("+ " + value + " 1")),
+                response("ok", "fn main() {\n  (" + value + " + 1);\n}\n"));
+    }
+  }
+  for (auto client : clients) {
+    ::close(client);
+  }
+
+  server.stop();
+  thread.join();
+}
+
+TEST(Server, SocketInUse) {
+  const std::string path = testing::TempDir() + "translator-in-use.sock";
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, path.c_str());
+  ::unlink(path.c_str());
+
+  // Socket of a stopped server is replaced.
+  auto stale = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_EQ(::bind(stale, reinterpret_cast<sockaddr *>(&address),
+                   sizeof address),
+            0);
+  ::close(stale);
+  translator::Server server({}, 1);
+  std::thread thread([&] { EXPECT_TRUE(server.listen(path)); });
+
+  auto client = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  while (::connect(client, reinterpret_cast<sockaddr *>(&address),
+                   sizeof address) != 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ::close(client);
+
+  // Running server keeps its path.
+  translator::Server second({}, 1);
+  EXPECT_FALSE(second.listen(path));
+  EXPECT_EQ(errno, EADDRINUSE);
+
+  server.stop();
+  thread.join();
+}
@@ -1,5 +1,16 @@
 #include "common.h"
 
+namespace {
+
+// Start and end of `main` in programs printing their results.
+const std::string outputMain =
+    "use std::io::Write;\n\n"
+    "fn main() {\n"
+    "  let mut __book_out = std::io::BufWriter::new(std::io::stdout().lock());\n";
+const std::string outputEnd = "  __book_out.flush().unwrap();\n}\n";
+
+} // namespace
+
 TEST(Statements, VariableDeclaration) {
   checkExpression("let x = 5", 
                   "fn main() {\n  let mut x = 5;\n}\n", 
@@ -17,56 +28,110 @@ TEST(Statements, Assignment) {
 
 TEST(Statements, PrintStatements) {
   checkExpression("print 42", 
-                  "fn main() {\n  print!(\"{}\", 42);\n}\n", 
+                  outputMain + "  write!(__book_out, \"{}\", 42).unwrap();\n" +
+                      outputEnd,
                   false);
 
   checkExpression("println 42", 
-                  "fn main() {\n  println!(\"{}\", 42);\n}\n",
+                  outputMain + "  writeln!(__book_out, \"{}\", 42).unwrap();\n" +
+                      outputEnd,
                   false);
 }
 
 TEST(Statements, ReadStatement) {
   checkExpression("x = read",
-                  "fn main() {\n  let mut line = String::new();\n"
-                  "  std::io::stdin().read_line(&mut line).unwrap();\n"
-                  "  let mut x = line.trim().parse().unwrap();\n}\n",
+                  "use std::io::BufRead;\n\n"
+                  "fn main() {\n"
+                  "  let mut __book_in = std::io::stdin().lock();\n"
+                  "  let mut __book_line = String::new();\n"
+                  "  __book_line.clear();\n"
+                  "  __book_in.read_line(&mut __book_line).unwrap();\n"
+                  "  let mut x: i32 = __book_line.trim().parse().unwrap();\n"
+                  "}\n",
+                  false);
+}
+
+TEST(Statements, ReadAndPrint) {
+  checkExpression("print 1 x = read println x",
+                  "use std::io::{BufRead, Write};\n\n"
+                  "fn main() {\n"
+                  "  let mut __book_in = std::io::stdin().lock();\n"
+                  "  let mut __book_line = String::new();\n"
+                  "  let mut __book_out = "
+                  "std::io::BufWriter::new(std::io::stdout().lock());\n"
+                  "  write!(__book_out, \"{}\", 1).unwrap();\n"
+                  "  __book_out.flush().unwrap();\n"
+                  "  __book_line.clear();\n"
+                  "  __book_in.read_line(&mut __book_line).unwrap();\n"
+                  "  let mut x: i32 = __book_line.trim().parse().unwrap();\n"
+                  "  writeln!(__book_out, \"{}\", x).unwrap();\n"
+                  "  __book_out.flush().unwrap();\n"
+                  "}\n",
+                  false);
+
+  checkExpression("let __book = 1 print __book",
+                  "use std::io::Write;\n\n"
+                  "fn main() {\n"
+                  "  let mut __book__out = "
+                  "std::io::BufWriter::new(std::io::stdout().lock());\n"
+                  "  let mut __book = 1;\n"
+                  "  write!(__book__out, \"{}\", __book).unwrap();\n"
+                  "  __book__out.flush().unwrap();\n"
+                  "}\n",
                   false);
 }
 
 TEST(Statements, IfStatement) {
   checkExpression("if == 1 1 { println 42 }",
-                  "fn main() {\n  if (1 == 1) {\n    println!(\"{}\", 42);\n  }\n}\n",
+                  outputMain + "  if (1 == 1) {\n"
+                  "    writeln!(__book_out, \"{}\", 42).unwrap();\n  }\n" +
+                      outputEnd,
                   false);
 }
 
 TEST(Statements, IfElseStatement) {
   checkExpression("if == 1 2 { println 42 } else { println 43 }",
-                  "fn main() {\n  if (1 == 2) {\n    println!(\"{}\", 42);\n  } else {\n"
-                  "    println!(\"{}\", 43);\n  }\n}\n",
+                  outputMain + "  if (1 == 2) {\n"
+                  "    writeln!(__book_out, \"{}\", 42).unwrap();\n  } else {\n"
+                  "    writeln!(__book_out, \"{}\", 43).unwrap();\n  }\n" +
+                      outputEnd,
                   false);
 }
 
 TEST(Statements, ComplexProgram) {
   checkExpression("let x = 5 if == x 5 { println x } else { print 0 }",
-                  "fn main() {\n"
-                  "  let mut x = 5;\n"
-                  "  if (x == 5) {\n"
-                  "    println!(\"{}\", x);\n"
-                  "  } else {\n"
-                  "    print!(\"{}\", 0);\n"
-                  "  }\n"
-                  "}\n",
+                  outputMain +
+                      "  let mut x = 5;\n"
+                      "  if (x == 5) {\n"
+                      "    writeln!(__book_out, \"{}\", x).unwrap();\n"
+                      "  } else {\n"
+                      "    write!(__book_out, \"{}\", 0).unwrap();\n"
+                      "  }\n" +
+                      outputEnd,
                   false);
 
   checkExpression("if > 2 3 print 3 if > 4 - 7 2 print + 3 4",
-                  "fn main() {\n"
-                  "  if (2 > 3) {\n"
-                  "    print!(\"{}\", 3);\n"
-                  "  } else {\n"
-                  "    if (4 > (7 - 2)) {\n"
-                  "      print!(\"{}\", (3 + 4));\n"
-                  "    }\n"
-                  "  }\n"
-                  "}\n",
+                  outputMain +
+                      "  if (2 > 3) {\n"
+                      "    write!(__book_out, \"{}\", 3).unwrap();\n"
+                      "  } else {\n"
+                      "    if (4 > (7 - 2)) {\n"
+                      "      write!(__book_out, \"{}\", (3 + 4)).unwrap();\n"
+                      "    }\n"
+                      "  }\n" +
+                      outputEnd,
                   false);
-}
\ No newline at end of file
+}
+
+TEST(Statements, StatementAfterIf) {
+  checkExpression("if 1 { print 1 } else { print 2 } print 3",
+                  outputMain +
+                      "  if 1 {\n"
+                      "    write!(__book_out, \"{}\", 1).unwrap();\n"
+                      "  } else {\n"
+                      "    write!(__book_out, \"{}\", 2).unwrap();\n"
+                      "  }\n"
+                      "  write!(__book_out, \"{}\", 3).unwrap();\n" +
+                      outputEnd,
+                  false);
+}
@@ -0,0 +1,236 @@
+#include "Batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "Cache.h"
+#include "MappedFile.h"
+
+namespace fs = std::filesystem;
+
+namespace translator {
+
+namespace {
+
+struct Job {
+  fs::path input;
+  fs::path output;
+};
+
+struct JobResult {
+  bool ok{};
+  std::uintmax_t bytes{};
+  std::string diagnostics;
+  book::Stats stats;
+};
+
+fs::path outputPath(const fs::path &input, const fs::path &root,
+                    const BatchOptions &options) {
+  auto output = input;
+  if (options.outputDirectory) {
+    output = *options.outputDirectory / input.lexically_relative(root);
+  }
+  return output.replace_extension(".rs");
+}
+
+// Reports a file that is not translated, before workers start.
+void reportFailure(const fs::path &input, const std::string &message) {
+  std::cerr << "FAILED " << input.string() << '\n' << message << '\n';
+}
+
+// Adds jobs of `.book` files under `root`. Directories and entries that
+// cannot be read are reported as failed, their number is added to
+// `failures`.
+void collectDirectory(const fs::path &root, const BatchOptions &options,
+                      std::vector<Job> &jobs, std::size_t &failures) {
+  std::vector<fs::path> directories{root};
+  while (!directories.empty()) {
+    const auto directory = std::move(directories.back());
+    directories.pop_back();
+
+    std::error_code error;
+    for (fs::directory_iterator it(directory, error), end;
+         !error && it != end; it.increment(error)) {
+      std::error_code entryError;
+      if (it->symlink_status(entryError).type() == fs::file_type::directory) {
+        directories.push_back(it->path());
+      } else if (it->path().extension() == ".book" &&
+                 it->is_regular_file(entryError)) {
+        jobs.push_back({it->path(), outputPath(it->path(), root, options)});
+      }
+      if (entryError) {
+        reportFailure(it->path(), entryError.message());
+        ++failures;
+      }
+    }
+    if (error) {
+      reportFailure(directory, error.message());
+      ++failures;
+    }
+  }
+}
+
+std::vector<Job> collectJobs(const std::vector<fs::path> &inputs,
+                             const BatchOptions &options,
+                             std::size_t &failures) {
+  std::vector<Job> jobs;
+  for (auto &&input : inputs) {
+    std::error_code error;
+    if (fs::is_directory(input, error)) {
+      collectDirectory(input, options, jobs, failures);
+    } else {
+      // Unreadable files fail when their job opens them.
+      jobs.push_back({input, outputPath(input, input.parent_path(), options)});
+    }
+  }
+  return jobs;
+}
+
+// Removes jobs whose output path is shared with another job or is one of the
+// inputs, their workers would write the same file concurrently or truncate
+// a source while it is read. Reports them as failed and returns their number.
+std::size_t removeConflicts(std::vector<Job> &jobs) {
+  std::set<fs::path> inputs;
+  std::map<fs::path, std::vector<std::size_t>> byOutput;
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    inputs.insert(fs::absolute(jobs[i].input).lexically_normal());
+    byOutput[fs::absolute(jobs[i].output).lexically_normal()].push_back(i);
+  }
+
+  std::vector<bool> conflicting(jobs.size());
+  for (auto &&[output, indices] : byOutput) {
+    const auto input = inputs.count(output) != 0;
+    if (!input && indices.size() < 2) {
+      continue;
+    }
+    for (auto i : indices) {
+      conflicting[i] = true;
+      reportFailure(jobs[i].input,
+                    "output " + output.string() +
+                        (input ? " is an input file"
+                               : " is shared with other inputs"));
+    }
+  }
+
+  std::vector<Job> kept;
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    if (!conflicting[i]) {
+      kept.push_back(std::move(jobs[i]));
+    }
+  }
+  const auto removed = jobs.size() - kept.size();
+  jobs = std::move(kept);
+  return removed;
+}
+
+JobResult runJob(const Job &job, const BatchOptions &options,
+                 Translator &translator) {
+  JobResult result;
+  std::ostringstream diagnostics;
+
+  const book::MappedFile input(job.input.string());
+  result.bytes = input.view().size();
+
+  auto output = translator(input.view(), fs::absolute(job.input).string(),
+                           options.translation, diagnostics,
+                           options.stats ? &result.stats : nullptr);
+  if (output) {
+    const auto start = std::chrono::steady_clock::now();
+    if (job.output.has_parent_path()) {
+      fs::create_directories(job.output.parent_path());
+    }
+    std::ofstream out(job.output, std::ios::binary);
+    out << *output;
+    out.close();
+    result.ok = static_cast<bool>(out);
+    result.stats.writeTime += std::chrono::steady_clock::now() - start;
+    if (!result.ok) {
+      diagnostics << "cannot write " << job.output.string() << '\n';
+    }
+  }
+
+  result.diagnostics = diagnostics.str();
+  return result;
+}
+
+} // namespace
+
+std::size_t runBatch(const std::vector<fs::path> &inputs,
+                     const BatchOptions &options) {
+  const auto start = std::chrono::steady_clock::now();
+  std::size_t failures = 0;
+  auto jobs = collectJobs(inputs, options, failures);
+  failures += removeConflicts(jobs);
+  const auto total = jobs.size() + failures;
+
+  std::atomic<std::size_t> nextJob{};
+  std::atomic<std::size_t> failed{failures};
+  std::atomic<std::uintmax_t> totalBytes{};
+  std::mutex reportMutex;
+
+  auto worker = [&] {
+    Translator translator;
+    for (auto i = nextJob++; i < jobs.size(); i = nextJob++) {
+      JobResult result;
+      try {
+        result = runJob(jobs[i], options, translator);
+      } catch (const std::exception &e) {
+        result.diagnostics += std::string(e.what()) + '\n';
+      }
+
+      totalBytes += result.bytes;
+      if (!result.ok) {
+        ++failed;
+      }
+
+      std::lock_guard lock(reportMutex);
+      if (options.stats) {
+        *options.stats += result.stats;
+      }
+      std::cerr << (result.ok ? "ok     " : "FAILED ") << jobs[i].input.string()
+                << '\n'
+                << result.diagnostics;
+    }
+  };
+
+  auto threads = options.jobs != 0
+                     ? options.jobs
+                     : std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::thread> workers;
+  for (std::size_t i = 0; i < std::min(threads, jobs.size()); ++i) {
+    workers.emplace_back(worker);
+  }
+  for (auto &&thread : workers) {
+    thread.join();
+  }
+
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  const double megabytes = totalBytes / (1024.0 * 1024.0);
+  std::cerr << "Translated " << total - failed << '/' << total
+            << " files (" << std::fixed << std::setprecision(2) << megabytes
+            << " MiB) in " << elapsed.count() << " s using " << workers.size()
+            << " threads: " << total / elapsed.count() << " files/s, "
+            << megabytes / elapsed.count() << " MiB/s\n";
+  if (auto cache = options.translation.cache) {
+    std::cerr << "Cache: " << cache->getHits() << " hits, "
+              << cache->getMisses() << " misses\n";
+  }
+
+  return failed;
+}
+
+} // namespace translator
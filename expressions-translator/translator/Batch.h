@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "Translation.h"
+
+namespace translator {
+
+struct BatchOptions {
+  // Number of worker threads, 0 means one per hardware thread.
+  std::size_t jobs{};
+  Options translation;
+  // Directory translated files are written to. By default each `.rs` file is
+  // placed next to its source.
+  std::optional<std::filesystem::path> outputDirectory;
+  // Statistics summed over all files, not collected if null.
+  book::Stats *stats{};
+};
+
+// Translates every input file, directories are searched recursively for
+// `.book` files. Files are translated concurrently, each worker owns its own
+// translator. Inputs that would be written to the same output file or over
+// an input file fail without being translated, so do directories that
+// cannot be read. Per-file status and total throughput are reported to
+// standard error. Returns number of failed files.
+std::size_t runBatch(const std::vector<std::filesystem::path> &inputs,
+                     const BatchOptions &options);
+
+} // namespace translator
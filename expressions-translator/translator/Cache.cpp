@@ -0,0 +1,232 @@
+#include "Cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Emitter.h"
+
+#ifndef TRANSLATOR_VERSION
+#define TRANSLATOR_VERSION "unknown"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace translator {
+
+namespace {
+
+constexpr std::uint64_t PRIME1 = 11400714785074694791ULL;
+constexpr std::uint64_t PRIME2 = 14029467366897019727ULL;
+constexpr std::uint64_t PRIME3 = 1609587929392839161ULL;
+constexpr std::uint64_t PRIME4 = 9650029242287828579ULL;
+constexpr std::uint64_t PRIME5 = 2870177450012600261ULL;
+
+// Temporary files of `store` are named `<entry>.tmp.<writer>`.
+constexpr char TEMPORARY_SUFFIX[] = ".tmp.";
+// Temporary files this old were left by a process that died before renaming
+// them into place.
+constexpr std::chrono::minutes STALE_TEMPORARY_AGE(1);
+
+std::uint64_t rotl(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+template <typename T> std::uint64_t read(const char *p) {
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  return value;
+}
+
+std::uint64_t round(std::uint64_t acc, std::uint64_t input) {
+  acc += input * PRIME2;
+  return rotl(acc, 31) * PRIME1;
+}
+
+std::uint64_t merge(std::uint64_t acc, std::uint64_t value) {
+  acc ^= round(0, value);
+  return acc * PRIME1 + PRIME4;
+}
+
+std::string hex(std::uint64_t value) {
+  static constexpr char digits[] = "0123456789abcdef";
+  std::string result(16, '0');
+  for (int i = 15; i >= 0; --i, value >>= 4) {
+    result[i] = digits[value & 0xF];
+  }
+  return result;
+}
+
+} // namespace
+
+std::uint64_t xxh64(std::string_view data, std::uint64_t seed) {
+  const char *p = data.data();
+  const char *end = p + data.size();
+  std::uint64_t h;
+
+  if (data.size() >= 32) {
+    std::uint64_t v1 = seed + PRIME1 + PRIME2;
+    std::uint64_t v2 = seed + PRIME2;
+    std::uint64_t v3 = seed;
+    std::uint64_t v4 = seed - PRIME1;
+    for (; p + 32 <= end; p += 32) {
+      v1 = round(v1, read<std::uint64_t>(p));
+      v2 = round(v2, read<std::uint64_t>(p + 8));
+      v3 = round(v3, read<std::uint64_t>(p + 16));
+      v4 = round(v4, read<std::uint64_t>(p + 24));
+    }
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    h = merge(h, v1);
+    h = merge(h, v2);
+    h = merge(h, v3);
+    h = merge(h, v4);
+  } else {
+    h = seed + PRIME5;
+  }
+
+  h += data.size();
+  for (; p + 8 <= end; p += 8) {
+    h ^= round(0, read<std::uint64_t>(p));
+    h = rotl(h, 27) * PRIME1 + PRIME4;
+  }
+  if (p + 4 <= end) {
+    h ^= read<std::uint32_t>(p) * PRIME1;
+    h = rotl(h, 23) * PRIME2 + PRIME3;
+    p += 4;
+  }
+  for (; p < end; ++p) {
+    h ^= static_cast<unsigned char>(*p) * PRIME5;
+    h = rotl(h, 11) * PRIME1;
+  }
+
+  h ^= h >> 33;
+  h *= PRIME2;
+  h ^= h >> 29;
+  h *= PRIME3;
+  h ^= h >> 32;
+  return h;
+}
+
+Cache::Cache(fs::path directory, std::uintmax_t maxSize)
+    : directory(std::move(directory)), maxSize(maxSize) {
+  fs::create_directories(this->directory);
+}
+
+std::string Cache::key(std::string_view source, std::string_view options) {
+  const auto seed = xxh64(std::string(TRANSLATOR_VERSION) + '\n' +
+                          std::to_string(book::OUTPUT_REVISION) + '\n' +
+                          std::string(options));
+  return hex(xxh64(source, seed));
+}
+
+fs::path Cache::entryPath(const std::string &key) const {
+  return directory / (key + ".rs");
+}
+
+std::optional<std::string> Cache::load(const std::string &key) {
+  const auto path = entryPath(key);
+  std::ifstream entry(path, std::ios::binary);
+  if (!entry) {
+    ++misses;
+    return {};
+  }
+
+  std::string value{std::istreambuf_iterator<char>(entry),
+                    std::istreambuf_iterator<char>()};
+  if (entry.bad()) {
+    ++misses;
+    return {};
+  }
+
+  // Refresh modification time, it is used as last access time by `trim`.
+  std::error_code ignored;
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ignored);
+  ++hits;
+  return value;
+}
+
+void Cache::store(const std::string &key, const std::string &value) {
+  static std::atomic<unsigned> counter{};
+  const auto path = entryPath(key);
+  auto temporary = path;
+  temporary += TEMPORARY_SUFFIX + std::to_string(getpid()) + '.' +
+               std::to_string(std::hash<std::thread::id>{}(
+                   std::this_thread::get_id())) +
+               '.' + std::to_string(counter++);
+
+  {
+    std::ofstream entry(temporary, std::ios::binary);
+    entry << value;
+    if (!entry.flush()) {
+      std::error_code ignored;
+      fs::remove(temporary, ignored);
+      return;
+    }
+  }
+
+  std::error_code error;
+  fs::rename(temporary, path, error);
+  if (error) {
+    fs::remove(temporary, error);
+    return;
+  }
+
+  if (++stores % TRIM_INTERVAL == 0) {
+    trim();
+  }
+}
+
+void Cache::trim() {
+  struct Entry {
+    fs::path path;
+    std::uintmax_t size;
+    fs::file_time_type time;
+  };
+
+  std::vector<Entry> entries;
+  std::uintmax_t total = 0;
+  const auto stale = fs::file_time_type::clock::now() - STALE_TEMPORARY_AGE;
+  std::error_code error;
+  for (auto &&file : fs::directory_iterator(directory, error)) {
+    if (file.path().filename().string().find(TEMPORARY_SUFFIX) !=
+        std::string::npos) {
+      auto time = file.last_write_time(error);
+      if (!error && time < stale) {
+        fs::remove(file.path(), error);
+      }
+      continue;
+    }
+    if (file.path().extension() != ".rs") {
+      continue;
+    }
+    auto size = file.file_size(error);
+    auto time = file.last_write_time(error);
+    if (!error) {
+      entries.push_back({file.path(), size, time});
+      total += size;
+    }
+  }
+
+  if (total <= maxSize) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](auto &&a, auto &&b) { return a.time < b.time; });
+  for (auto &&entry : entries) {
+    if (total <= maxSize) {
+      break;
+    }
+    fs::remove(entry.path, error);
+    total -= entry.size;
+  }
+}
+
+} // namespace translator
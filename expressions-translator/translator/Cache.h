@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace translator {
+
+// 64-bit xxHash (XXH64) of `data`.
+std::uint64_t xxh64(std::string_view data, std::uint64_t seed = 0);
+
+// Persistent content-addressed cache of translation results.
+//
+// Entries are keyed by hash of the source, translator version, revision of
+// the emitted code and options, stored as one file per entry and written
+// atomically (to a temporary file renamed into place), so several translator
+// processes may share a cache directory. Least recently used entries are
+// evicted by `trim` once the directory grows beyond its size limit, which
+// `store` also does periodically for long-running processes.
+class Cache {
+public:
+  // `store` trims the cache after every this many stored entries.
+  static constexpr std::size_t TRIM_INTERVAL = 256;
+
+  // Creates `directory` if needed, throws `std::filesystem::filesystem_error`
+  // if it cannot be created.
+  Cache(std::filesystem::path directory, std::uintmax_t maxSize);
+
+  static std::string key(std::string_view source, std::string_view options);
+
+  std::optional<std::string> load(const std::string &key);
+  void store(const std::string &key, const std::string &value);
+
+  // Removes least recently used entries until cache fits its size limit,
+  // and temporary files left behind by crashed writers.
+  void trim();
+
+  std::size_t getHits() const { return hits; }
+  std::size_t getMisses() const { return misses; }
+
+private:
+  std::filesystem::path entryPath(const std::string &key) const;
+
+  std::filesystem::path directory;
+  std::uintmax_t maxSize;
+
+  std::atomic<std::size_t> hits{};
+  std::atomic<std::size_t> misses{};
+  // Successful stores, used to trim periodically.
+  std::atomic<std::size_t> stores{};
+};
+
+} // namespace translator
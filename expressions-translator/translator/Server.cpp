@@ -0,0 +1,442 @@
+#include "Server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace translator {
+
+namespace {
+
+constexpr std::size_t MAX_HEADER_SIZE = 4096;
+
+// Pause of accepting after running out of file descriptors or memory.
+constexpr std::chrono::milliseconds ACCEPT_BACKOFF(100);
+
+// Buffered reader of a file descriptor.
+class Reader {
+public:
+  explicit Reader(int fd) : fd(fd) {}
+
+  // Reads a line without the trailing newline, fails on end of input or if
+  // the line is longer than `MAX_HEADER_SIZE`.
+  bool line(std::string &out) {
+    for (std::size_t searched = 0;;) {
+      auto end = buffer.find('\n', position + searched);
+      if (end != std::string::npos) {
+        out.assign(buffer, position, end - position);
+        position = end + 1;
+        return true;
+      }
+      searched = buffer.size() - position;
+      if (searched > MAX_HEADER_SIZE || !fill()) {
+        return false;
+      }
+    }
+  }
+
+  // Reads exactly `size` bytes, fails on end of input.
+  bool read(std::size_t size, std::string &out) {
+    out.clear();
+    while (buffer.size() - position < size) {
+      out.append(buffer, position);
+      size -= buffer.size() - position;
+      buffer.clear();
+      position = 0;
+      if (!fill()) {
+        return false;
+      }
+    }
+    out.append(buffer, position, size);
+    position += size;
+    return true;
+  }
+
+  // Whether part of the next request has been read already.
+  bool buffered() const noexcept { return position < buffer.size(); }
+
+private:
+  bool fill() {
+    buffer.erase(0, position);
+    position = 0;
+
+    char chunk[64 * 1024];
+    for (;;) {
+      auto count = ::read(fd, chunk, sizeof chunk);
+      if (count > 0) {
+        buffer.append(chunk, count);
+        return true;
+      }
+      if (count == 0 || errno != EINTR) {
+        return false;
+      }
+    }
+  }
+
+  int fd;
+  std::string buffer;
+  std::size_t position{};
+};
+
+// Writes the whole `data`, sockets are written without raising SIGPIPE.
+bool writeAll(int fd, bool socket, std::string_view data) {
+  while (!data.empty()) {
+    auto count = socket ? ::send(fd, data.data(), data.size(), MSG_NOSIGNAL)
+                        : ::write(fd, data.data(), data.size());
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data.remove_prefix(count);
+  }
+  return true;
+}
+
+bool isSocket(int fd) {
+  struct stat status;
+  return ::fstat(fd, &status) == 0 && S_ISSOCK(status.st_mode);
+}
+
+bool respond(int fd, bool socket, bool ok, std::string_view body,
+             std::string &buffer) {
+  buffer = ok ? "ok " : "error ";
+  buffer += std::to_string(body.size());
+  buffer += '\n';
+  buffer += body;
+  return writeAll(fd, socket, buffer);
+}
+
+struct Request {
+  std::size_t length{};
+  Options options;
+  std::optional<std::string> name;
+};
+
+// Parses request header, returns error message on failure.
+std::optional<std::string> parseHeader(std::string_view header,
+                                       Request &request) {
+  std::vector<std::string_view> words;
+  while (!header.empty()) {
+    auto end = std::min(header.find(' '), header.size());
+    if (end != 0) {
+      words.push_back(header.substr(0, end));
+    }
+    header.remove_prefix(std::min(end + 1, header.size()));
+  }
+
+  if (words.size() < 2 || words[0] != "translate") {
+    return "expected `translate LENGTH [OPTION...]` request";
+  }
+  if (!parseNumber(words[1], request.length)) {
+    return "invalid source length: " + std::string(words[1]);
+  }
+  if (request.length > Server::MAX_SOURCE_SIZE) {
+    return "source length " + std::string(words[1]) + " exceeds " +
+           std::to_string(Server::MAX_SOURCE_SIZE) + " bytes";
+  }
+
+  for (std::size_t i = 2; i < words.size(); ++i) {
+    auto word = words[i];
+    if (word.rfind("max-errors=", 0) == 0) {
+      word.remove_prefix(std::strlen("max-errors="));
+      if (!parseNumber(word, request.options.maxErrors)) {
+        return "invalid max-errors: " + std::string(word);
+      }
+    } else if (word == "cse") {
+      request.options.cse = true;
+    } else if (word.rfind("name=", 0) == 0) {
+      request.name = std::string(word.substr(std::strlen("name=")));
+    } else {
+      return "unknown option: " + std::string(word);
+    }
+  }
+  return {};
+}
+
+// Buffers reused by all requests answered on one thread.
+struct Buffers {
+  std::string header;
+  std::string source;
+  std::string response;
+  std::ostringstream diagnostics;
+};
+
+// Reads and answers one request, returns false if the connection is to be
+// closed.
+bool answer(Reader &reader, int out, bool socket, const Options &defaults,
+            Translator &translator, Buffers &buffers) {
+  if (!reader.line(buffers.header)) {
+    return false;
+  }
+  Request request{{}, defaults, {}};
+  if (auto error = parseHeader(buffers.header, request)) {
+    respond(out, socket, false, *error + '\n', buffers.response);
+    return false;
+  }
+  if (!reader.read(request.length, buffers.source)) {
+    return false;
+  }
+
+  auto &&diagnostics = buffers.diagnostics;
+  diagnostics.str({});
+  diagnostics.clear();
+  std::optional<std::string> result;
+  try {
+    result =
+        translator(buffers.source, request.name, request.options, diagnostics);
+  } catch (const std::exception &e) {
+    diagnostics << e.what() << '\n';
+  }
+
+  return result ? respond(out, socket, true, *result, buffers.response)
+                : respond(out, socket, false, diagnostics.str(),
+                          buffers.response);
+}
+
+// Wakes up `poll` on the other end of the pipe, a full pipe does already.
+void wake(int fd) {
+  [[maybe_unused]] auto written = ::write(fd, "", 1);
+}
+
+} // namespace
+
+struct Server::Connection {
+  explicit Connection(int fd) : fd(fd), reader(fd) {}
+  ~Connection() { ::close(fd); }
+
+  const int fd;
+  Reader reader;
+};
+
+Server::Server(Options options, std::size_t jobs)
+    : options(options),
+      jobs(jobs != 0 ? jobs : std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+Server::~Server() = default;
+
+void Server::serve(int in, int out) {
+  Translator translator;
+  Reader reader(in);
+  Buffers buffers;
+  const auto socket = isSocket(out);
+  while (answer(reader, out, socket, options, translator, buffers)) {
+  }
+}
+
+bool Server::listen(const fs::path &path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.native().size() >= sizeof address.sun_path) {
+    errno = ENAMETOOLONG;
+    return false;
+  }
+  std::strcpy(address.sun_path, path.c_str());
+
+  if (fs::is_socket(path)) {
+    // Take over the path only from a server that is gone.
+    auto probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe < 0) {
+      return false;
+    }
+    auto alive = ::connect(probe, reinterpret_cast<sockaddr *>(&address),
+                           sizeof address) == 0;
+    ::close(probe);
+    if (alive) {
+      errno = EADDRINUSE;
+      return false;
+    }
+    ::unlink(path.c_str());
+  }
+
+  int wakeups[2];
+  if (::pipe2(wakeups, O_NONBLOCK | O_CLOEXEC) != 0) {
+    return false;
+  }
+  auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0 ||
+      ::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof address) != 0 ||
+      ::listen(fd, SOMAXCONN) != 0) {
+    auto error = errno;
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    ::close(wakeups[0]);
+    ::close(wakeups[1]);
+    errno = error;
+    return false;
+  }
+
+  {
+    std::lock_guard lock(mutex);
+    wakeup = wakeups[1];
+  }
+  std::vector<std::thread> workers;
+  for (std::size_t i = 0; i < jobs; ++i) {
+    workers.emplace_back(&Server::work, this);
+  }
+
+  std::vector<pollfd> fds{{wakeups[0], POLLIN, 0}, {fd, POLLIN, 0}};
+  auto resume = std::chrono::steady_clock::now();
+  int error = 0;
+  for (;;) {
+    std::size_t polled;
+    {
+      std::lock_guard lock(mutex);
+      if (stopping) {
+        break;
+      }
+      fds.resize(2);
+      for (auto &&connection : idle) {
+        fds.push_back({connection->fd, POLLIN, 0});
+      }
+      polled = idle.size();
+    }
+
+    auto timeout = -1;
+    fds[1].events = POLLIN;
+    if (auto now = std::chrono::steady_clock::now(); now < resume) {
+      fds[1].events = 0;
+      timeout = std::chrono::ceil<std::chrono::milliseconds>(resume - now)
+                    .count();
+    }
+    if (::poll(fds.data(), fds.size(), timeout) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      error = errno;
+      break;
+    }
+
+    for (char drain[64]; ::read(wakeups[0], drain, sizeof drain) > 0;) {
+    }
+
+    std::lock_guard lock(mutex);
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < idle.size(); ++i) {
+      if (i < polled && fds[2 + i].revents != 0) {
+        ready.push_back(std::move(idle[i]));
+        pending.notify_one();
+      } else {
+        idle[kept++] = std::move(idle[i]);
+      }
+    }
+    idle.resize(kept);
+
+    if (fds[1].revents == 0) {
+      continue;
+    }
+    for (;;) {
+      auto client = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+      if (client >= 0) {
+        idle.push_back(std::make_unique<Connection>(client));
+        continue;
+      }
+      if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO) {
+        continue;
+      }
+      if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS ||
+          errno == ENOMEM) {
+        // Connections are left in the backlog until some are closed.
+        resume = std::chrono::steady_clock::now() + ACCEPT_BACKOFF;
+      } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        error = errno;
+      }
+      break;
+    }
+    if (error != 0) {
+      break;
+    }
+  }
+
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+    for (auto client : active) {
+      ::shutdown(client, SHUT_RDWR);
+    }
+    pending.notify_all();
+  }
+  for (auto &&worker : workers) {
+    worker.join();
+  }
+
+  std::lock_guard lock(mutex);
+  ready.clear();
+  idle.clear();
+  wakeup = -1;
+  ::close(wakeups[0]);
+  ::close(wakeups[1]);
+  ::close(fd);
+  ::unlink(path.c_str());
+  errno = error;
+  return error == 0;
+}
+
+void Server::stop() {
+  std::lock_guard lock(mutex);
+  stopping = true;
+  if (wakeup >= 0) {
+    wake(wakeup);
+  }
+  for (auto client : active) {
+    ::shutdown(client, SHUT_RDWR);
+  }
+  pending.notify_all();
+}
+
+void Server::work() {
+  Translator translator;
+  Buffers buffers;
+  for (;;) {
+    std::unique_ptr<Connection> connection;
+    {
+      std::unique_lock lock(mutex);
+      pending.wait(lock, [this] { return stopping || !ready.empty(); });
+      if (stopping) {
+        return;
+      }
+      connection = std::move(ready.front());
+      ready.pop_front();
+      active.insert(connection->fd);
+    }
+
+    auto open = answer(connection->reader, connection->fd, true, options,
+                       translator, buffers);
+
+    std::lock_guard lock(mutex);
+    active.erase(connection->fd);
+    if (!open || stopping) {
+      continue;
+    }
+    if (connection->reader.buffered()) {
+      // Next request was sent along with this one.
+      ready.push_back(std::move(connection));
+      pending.notify_one();
+    } else {
+      idle.push_back(std::move(connection));
+      wake(wakeup);
+    }
+  }
+}
+
+} // namespace translator
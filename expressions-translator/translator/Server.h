@@ -0,0 +1,79 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "Translation.h"
+
+namespace translator {
+
+// Long-running translator answering framed requests, so that editors and
+// build systems do not pay process startup for every snippet.
+//
+// Request is a header line followed by `LENGTH` bytes of source:
+//
+//     translate LENGTH [max-errors=N] [cse] [name=NAME]\n<source>
+//
+// `max-errors` overrides the server default, `cse` enables common
+// subexpression elimination and `NAME` is used in diagnostics.
+// Response is a header line followed by `LENGTH` bytes of rust code or
+// diagnostics:
+//
+//     ok LENGTH\n<rust code>
+//     error LENGTH\n<diagnostics>
+//
+// Malformed header and source longer than `MAX_SOURCE_SIZE` are answered by
+// an `error` and close the connection.
+class Server {
+public:
+  static constexpr std::size_t MAX_SOURCE_SIZE = 64 * 1024 * 1024;
+
+  // `jobs` is number of requests translated concurrently, 0 means one per
+  // hardware thread.
+  Server(Options options, std::size_t jobs);
+  ~Server();
+
+  Server(const Server &) = delete;
+  Server &operator=(const Server &) = delete;
+
+  // Serves requests read from `in` until end of input, responses are written
+  // to `out`.
+  void serve(int in, int out);
+
+  // Listens on unix domain socket at `path` until `stop()` is called. Idle
+  // connections are polled and every request is answered by the next free
+  // worker, so clients may stay connected however many of them there are.
+  // Returns false with `errno` set if the socket could not be created,
+  // another server is listening at `path` or accepting failed.
+  bool listen(const std::filesystem::path &path);
+
+  // Stops `listen()`, open connections are shut down.
+  void stop();
+
+private:
+  struct Connection;
+
+  bool poll(int listener);
+  void work();
+
+  const Options options;
+  const std::size_t jobs;
+
+  std::mutex mutex;
+  std::condition_variable pending;
+  // Connections with a request to answer, waiting for a worker.
+  std::deque<std::unique_ptr<Connection>> ready;
+  // Connections waiting for the next request, polled by `listen()`.
+  std::vector<std::unique_ptr<Connection>> idle;
+  std::set<int> active;
+  // Write end of the pipe waking `listen()` up, -1 when not listening.
+  int wakeup{-1};
+  bool stopping{};
+};
+
+} // namespace translator
@@ -0,0 +1,73 @@
+#include "Statistics.h"
+
+#include <chrono>
+#include <iomanip>
+
+#include <sys/resource.h>
+
+namespace {
+
+double milliseconds(book::Stats::Duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+std::string jsonString(const std::string &value) {
+  static constexpr char digits[] = "0123456789abcdef";
+  std::string result = "\"";
+  for (char ch : value) {
+    const auto code = static_cast<unsigned char>(ch);
+    if (ch == '"' || ch == '\\') {
+      result += '\\';
+      result += ch;
+    } else if (code < 0x20) {
+      result += "\\u00";
+      result += digits[code >> 4];
+      result += digits[code & 0xF];
+    } else {
+      result += ch;
+    }
+  }
+  return result + '"';
+}
+
+} // namespace
+
+namespace translator {
+
+std::size_t peakRss() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+}
+
+void printStats(const book::Stats &stats, const std::string &input, bool json,
+                std::ostream &out) {
+  const auto parseTime = stats.parseTime - stats.lexTime - stats.emitTime;
+  if (json) {
+    out << std::fixed << std::setprecision(3) << "{\"input\": "
+        << jsonString(input) << ", \"lex_ms\": " << milliseconds(stats.lexTime)
+        << ", \"parse_ms\": " << milliseconds(parseTime)
+        << ", \"emit_ms\": " << milliseconds(stats.emitTime)
+        << ", \"write_ms\": " << milliseconds(stats.writeTime)
+        << ", \"tokens\": " << stats.tokens
+        << ", \"reductions\": " << stats.reductions
+        << ", \"max_stack_depth\": " << stats.maxStackDepth
+        << ", \"semantic_value_bytes\": " << stats.semanticValueBytes
+        << ", \"peak_rss_bytes\": " << peakRss() << "}\n";
+    return;
+  }
+
+  out << std::fixed << std::setprecision(3) << "Statistics for " << input
+      << ":\n"
+      << "  lexing:           " << milliseconds(stats.lexTime) << " ms\n"
+      << "  parsing:          " << milliseconds(parseTime) << " ms\n"
+      << "  emitting:         " << milliseconds(stats.emitTime) << " ms\n"
+      << "  writing:          " << milliseconds(stats.writeTime) << " ms\n"
+      << "  tokens:           " << stats.tokens << '\n'
+      << "  reductions:       " << stats.reductions << '\n'
+      << "  max stack depth:  " << stats.maxStackDepth << '\n'
+      << "  semantic values:  " << stats.semanticValueBytes << " bytes\n"
+      << "  peak RSS:         " << peakRss() / 1024 << " KiB\n";
+}
+
+} // namespace translator
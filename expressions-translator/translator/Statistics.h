@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "Stats.h"
+
+namespace translator {
+
+// Peak resident set size of the process, in bytes.
+std::size_t peakRss();
+
+// Prints statistics as a table or as a JSON object.
+void printStats(const book::Stats &stats, const std::string &input, bool json,
+                std::ostream &out);
+
+} // namespace translator
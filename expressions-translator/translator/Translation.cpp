@@ -0,0 +1,68 @@
+#include "Translation.h"
+
+#include <chrono>
+
+#include "Cache.h"
+#include "Context.h"
+#include "LexicalAnalyzer.h"
+#include "Parser.tab.h"
+
+namespace translator {
+
+Translator::Translator()
+    : context(std::make_unique<book::Context>()),
+      lexer(std::make_unique<book::LexicalAnalyzer>(std::string_view(),
+                                                    *context)),
+      parser(std::make_unique<book::Parser>(*context, *lexer)) {}
+
+Translator::~Translator() = default;
+
+std::optional<std::string>
+Translator::operator()(std::string_view source,
+                       const std::optional<std::string> &filename,
+                       const Options &options, std::ostream &diagnostics,
+                       book::Stats *stats) {
+  std::string key;
+  if (options.cache) {
+    key = Cache::key(source, options.outputOptions());
+    if (auto cached = options.cache->load(key)) {
+      return cached;
+    }
+  }
+
+  context->reset(filename);
+  context->setErrorLimit(options.maxErrors);
+  context->setEmitOptions({options.cse});
+  context->setDiagnostics(diagnostics);
+  context->setSource(source);
+  context->setStats(stats);
+  lexer->reset(source);
+
+  int status;
+  if (stats) {
+    const auto start = std::chrono::steady_clock::now();
+    status = (*parser)();
+    stats->parseTime += std::chrono::steady_clock::now() - start;
+    context->countProgramValues();
+  } else {
+    status = (*parser)();
+  }
+
+  if (status != 0 || !context->getResult()) {
+    return {};
+  }
+
+  if (options.cache) {
+    options.cache->store(key, *context->getResult());
+  }
+  return context->getResult();
+}
+
+std::optional<std::string>
+translate(std::string_view source, const std::optional<std::string> &filename,
+          const Options &options, std::ostream &diagnostics,
+          book::Stats *stats) {
+  return Translator()(source, filename, options, diagnostics, stats);
+}
+
+} // namespace translator
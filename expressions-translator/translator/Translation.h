@@ -0,0 +1,73 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "Stats.h"
+
+namespace book {
+class Context;
+class LexicalAnalyzer;
+class Parser;
+} // namespace book
+
+namespace translator {
+
+class Cache;
+
+struct Options {
+  std::size_t maxErrors{20};
+  // Common subexpression elimination, see book::EmitOptions.
+  bool cse{};
+  // Cache of translation results, disabled if null.
+  Cache *cache{};
+
+  // Options affecting translation output, part of the cache key.
+  std::string outputOptions() const { return cse ? "cse" : ""; }
+};
+
+// Parses the whole `text` as a decimal number, used for option values.
+template <typename Number>
+bool parseNumber(std::string_view text, Number &value) {
+  auto end = text.data() + text.size();
+  auto [last, error] = std::from_chars(text.data(), end, value);
+  return error == std::errc() && last == end;
+}
+
+// Context, lexer and parser reused across translations, so repeated
+// translations of small sources do not reallocate their buffers. Not thread
+// safe, use one translator per thread.
+class Translator {
+public:
+  Translator();
+  ~Translator();
+
+  Translator(const Translator &) = delete;
+  Translator &operator=(const Translator &) = delete;
+
+  // See `translate` below.
+  std::optional<std::string>
+  operator()(std::string_view source, const std::optional<std::string> &filename,
+             const Options &options, std::ostream &diagnostics,
+             book::Stats *stats = nullptr);
+
+private:
+  std::unique_ptr<book::Context> context;
+  std::unique_ptr<book::LexicalAnalyzer> lexer;
+  std::unique_ptr<book::Parser> parser;
+};
+
+// Translates `source` to rust, errors are reported to `diagnostics`.
+// `filename` is used in diagnostics and for source snippets. If `stats` is
+// set, lexing and parsing statistics are added to it.
+std::optional<std::string>
+translate(std::string_view source, const std::optional<std::string> &filename,
+          const Options &options, std::ostream &diagnostics,
+          book::Stats *stats = nullptr);
+
+} // namespace translator
@@ -1,48 +1,186 @@
+#include <cerrno>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
-#include "Context.h"
-#include "LexicalAnalyzer.h"
-#include "Parser.tab.h"
+#include <unistd.h>
+
+#include "Batch.h"
+#include "Cache.h"
+#include "MappedFile.h"
+#include "Server.h"
+#include "Statistics.h"
+#include "Translation.h"
 
 enum class DataMode { Console, File };
 
 int main(int argc, char *argv[]) {
   const char *program_name = argc > 0 ? argv[0] : "translator";
-  if (argc < 1 || argc > 4) {
-    std::cerr << "Wrong arguments count. Usage: " << program_name
-              << " [input file] [output file]" << std::endl;
-    return EXIT_FAILURE;
+  const std::string options_usage =
+      "[--max-errors=N] [--cse] [--cache-dir=DIR [--cache-size=BYTES]] "
+      "[--stats[=json]]";
+  const std::string usage =
+      std::string("Usage: ") + program_name + " " + options_usage +
+      " [input file] [output file]\n       " + program_name +
+      " --batch [--jobs=N] [--output-dir=DIR] " + options_usage +
+      " [input file or directory]...\n       " + program_name +
+      " --server [--socket=PATH [--jobs=N]] [--max-errors=N] [--cse] "
+      "[--cache-dir=DIR [--cache-size=BYTES]]";
+
+  std::vector<std::string> files;
+  bool batch = false;
+  bool server = false;
+  std::optional<std::filesystem::path> socket_path;
+  translator::BatchOptions batch_options;
+  auto &options = batch_options.translation;
+  std::optional<std::filesystem::path> cache_dir;
+  std::uintmax_t cache_size = 256 * 1024 * 1024;
+  std::optional<book::Stats> stats;
+  bool stats_json = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = arg.substr(arg.find('=') + 1);
+    bool valid = true;
+    if (arg.rfind("--max-errors=", 0) == 0) {
+      valid = translator::parseNumber(value, options.maxErrors);
+    } else if (arg == "--cse") {
+      options.cse = true;
+    } else if (arg.rfind("--cache-dir=", 0) == 0) {
+      valid = !value.empty();
+      cache_dir = value;
+    } else if (arg.rfind("--cache-size=", 0) == 0) {
+      valid = translator::parseNumber(value, cache_size);
+    } else if (arg == "--stats" || arg == "--stats=json") {
+      stats.emplace();
+      stats_json = arg == "--stats=json";
+    } else if (arg == "--batch") {
+      batch = true;
+    } else if (arg == "--server") {
+      server = true;
+    } else if (arg.rfind("--socket=", 0) == 0) {
+      valid = !value.empty();
+      socket_path = value;
+    } else if (arg.rfind("--jobs=", 0) == 0) {
+      valid = translator::parseNumber(value, batch_options.jobs);
+    } else if (arg.rfind("--output-dir=", 0) == 0) {
+      valid = !value.empty();
+      batch_options.outputDirectory = value;
+    } else if (arg.rfind("--", 0) == 0) {
+      std::cerr << "Unknown option " << arg << ". " << usage << std::endl;
+      return EXIT_FAILURE;
+    } else {
+      files.push_back(std::move(arg));
+    }
+
+    if (!valid) {
+      std::cerr << "Invalid option " << arg << ". " << usage << std::endl;
+      return EXIT_FAILURE;
+    }
   }
 
-  auto input_mode = argc >= 2 ? DataMode::File : DataMode::Console;
-  auto output_mode = argc == 3 ? DataMode::File : DataMode::Console;
+  std::unique_ptr<translator::Cache> cache;
+  if (cache_dir) {
+    try {
+      cache = std::make_unique<translator::Cache>(*cache_dir, cache_size);
+    } catch (const std::filesystem::filesystem_error &e) {
+      std::cerr << "Invalid option --cache-dir=" << cache_dir->string() << ": "
+                << e.code().message() << ". " << usage << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  options.cache = cache.get();
+  auto stats_ptr = stats ? &*stats : nullptr;
+
+  if (server) {
+    if (batch || stats || !files.empty()) {
+      std::cerr << "Server mode takes no files, --batch or --stats. " << usage
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    translator::Server daemon(options, batch_options.jobs);
+    if (!socket_path) {
+      daemon.serve(STDIN_FILENO, STDOUT_FILENO);
+    } else if (!daemon.listen(*socket_path)) {
+      std::cerr << "Cannot listen on " << socket_path->string() << ": "
+                << std::strerror(errno) << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (cache) {
+      cache->trim();
+    }
+    return EXIT_SUCCESS;
+  }
 
-  auto in = input_mode == DataMode::Console
-                ? std::unique_ptr<std::ifstream>()
-                : std::make_unique<std::ifstream>(argv[1]);
+  if (batch) {
+    std::vector<std::filesystem::path> inputs(files.begin(), files.end());
+    batch_options.stats = stats_ptr;
+    auto failed = translator::runBatch(inputs, batch_options);
+    if (cache) {
+      cache->trim();
+    }
+    if (stats) {
+      translator::printStats(*stats, "batch", stats_json, std::cerr);
+    }
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
 
-  auto out = output_mode == DataMode::Console
-                 ? std::unique_ptr<std::ofstream>()
-                 : std::make_unique<std::ofstream>(argv[2]);
+  if (files.size() > 2) {
+    std::cerr << "Wrong arguments count. " << usage << std::endl;
+    return EXIT_FAILURE;
+  }
 
-  auto context = input_mode == DataMode::Console
-                     ? book::Context{}
-                     : book::Context{std::filesystem::absolute(argv[1])};
-  book::LexicalAnalyzer lexer(in.get(), context);
-  book::Parser parser(context, lexer);
+  auto input_mode = files.size() >= 1 ? DataMode::File : DataMode::Console;
+  auto output_mode = files.size() == 2 ? DataMode::File : DataMode::Console;
 
-  int result = parser();
-  if (auto parsed_result = context.getResult(); parsed_result) {
-    if (output_mode == DataMode::Console) {
-      std::cout << *parsed_result;
+  std::string console_source;
+  std::unique_ptr<book::MappedFile> file;
+  try {
+    if (input_mode == DataMode::Console) {
+      console_source.assign(std::istreambuf_iterator<char>(std::cin),
+                            std::istreambuf_iterator<char>());
     } else {
-      *out << *parsed_result;
+      file = std::make_unique<book::MappedFile>(files[0]);
     }
+  } catch (const std::system_error &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
   }
+  const std::string_view source = file ? file->view() : console_source;
 
-  return result;
-}
\ No newline at end of file
+  auto filename = input_mode == DataMode::Console
+                      ? std::optional<std::string>()
+                      : std::filesystem::absolute(files[0]).string();
+  auto result =
+      translator::translate(source, filename, options, std::cerr, stats_ptr);
+  if (cache) {
+    cache->trim();
+  }
+  if (!result) {
+    return EXIT_FAILURE;
+  }
+
+  const auto write_start = std::chrono::steady_clock::now();
+  if (output_mode == DataMode::Console) {
+    std::cout << *result << std::flush;
+  } else {
+    std::ofstream(files[1]) << *result;
+  }
+
+  if (stats) {
+    stats->writeTime = std::chrono::steady_clock::now() - write_start;
+    translator::printStats(*stats, filename.value_or("<stdin>"), stats_json,
+                           std::cerr);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Bdd.h>
+
+#include "Generator.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// Keeps the compiler from dropping unused results.
+volatile double sink;
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  benchmarks::GeneratorOptions options;
+  options.variables = 12;
+  options.membership = 20;
+  std::size_t formulas = 200;
+  std::size_t clauses = 20;
+  std::size_t evaluations = 1000000;
+  std::string order;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = arg.substr(arg.find('=') + 1);
+    if (arg.rfind("--order=", 0) == 0) {
+      order = value;
+    } else if (arg.rfind("--seed=", 0) == 0) {
+      options.seed = std::stoull(value);
+    } else if (arg.rfind("--variables=", 0) == 0) {
+      options.variables = std::stoull(value);
+    } else if (arg.rfind("--formulas=", 0) == 0) {
+      formulas = std::stoull(value);
+    } else if (arg.rfind("--clauses=", 0) == 0) {
+      clauses = std::stoull(value);
+    } else if (arg.rfind("--evaluations=", 0) == 0) {
+      evaluations = std::stoull(value);
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--order=LETTERS] [--seed=N] [--variables=N]"
+                   " [--formulas=N] [--clauses=N] [--evaluations=N]\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  benchmarks::FormulaGenerator generator(options);
+  std::vector<Formula> parsed;
+  for (std::size_t i = 0; i < formulas; ++i) {
+    parsed.emplace_back(generator.generate(clauses));
+  }
+
+  BddManager manager(order);
+  std::vector<BddManager::Node> nodes;
+  auto start = Clock::now();
+  for (auto &&formula : parsed) {
+    nodes.push_back(manager.compile(formula));
+  }
+  const auto compileMs = millisecondsSince(start);
+
+  start = Clock::now();
+  double models = 0;
+  for (auto node : nodes) {
+    models += manager.satCount(node);
+  }
+  const auto satCountMs = millisecondsSince(start);
+  sink = models;
+
+  std::mt19937 random(42);
+  std::vector<Assignment> assignments(1024);
+  for (auto &&assignment : assignments) {
+    assignment = {static_cast<std::uint32_t>(random()),
+                  static_cast<std::uint32_t>(random()),
+                  static_cast<std::uint32_t>(random())};
+  }
+
+  std::size_t walkSatisfied = 0;
+  start = Clock::now();
+  for (std::size_t i = 0; i < evaluations; ++i) {
+    walkSatisfied += parsed[i % formulas].evaluate(
+        assignments[i % assignments.size()]);
+  }
+  const auto walkNs = millisecondsSince(start) * 1e6 / evaluations;
+
+  std::size_t bddSatisfied = 0;
+  start = Clock::now();
+  for (std::size_t i = 0; i < evaluations; ++i) {
+    bddSatisfied += manager.evaluate(nodes[i % formulas],
+                                     assignments[i % assignments.size()]);
+  }
+  const auto bddNs = millisecondsSince(start) * 1e6 / evaluations;
+
+  if (walkSatisfied != bddSatisfied) {
+    std::cerr << "BDD evaluation differs from the formula one\n";
+    return EXIT_FAILURE;
+  }
+
+  std::size_t formulaNodes = 0;
+  for (auto &&formula : parsed) {
+    formulaNodes += formula.nodes().size();
+  }
+  std::cout << std::fixed << std::setprecision(2) << formulas
+            << " formulas, " << formulaNodes << " formula nodes\n"
+            << "compile: " << compileMs << " ms, "
+            << formulas / compileMs * 1000 << " formulas/s\n"
+            << "bdd: " << manager.size() << " nodes, "
+            << manager.memoryUsage() / (1024.0 * 1024) << " MiB\n"
+            << "satCount: " << satCountMs * 1000 / formulas
+            << " us per formula\n"
+            << "evaluation: tree walk " << walkNs << " ns, bdd " << bddNs
+            << " ns\n";
+}
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Formula.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double nanosecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start)
+      .count();
+}
+
+constexpr FixedString RULE = "(a and not b or c in d) xor (e or f and g) or "
+                             "not (h xor i) and j not in k in l or "
+                             "(m or n) and (o or p) and not (q and r)";
+
+// Keeps the compiler from dropping unused results.
+volatile std::size_t sink;
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::size_t parses = 100000;
+  std::size_t evaluations = 10000000;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = std::stoull(arg.substr(arg.find('=') + 1));
+    if (arg.rfind("--parses=", 0) == 0) {
+      parses = value;
+    } else if (arg.rfind("--evaluations=", 0) == 0) {
+      evaluations = value;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--parses=N] [--evaluations=N]\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  auto start = Clock::now();
+  std::size_t nodes = 0;
+  for (std::size_t i = 0; i < parses; ++i) {
+    nodes += Formula(RULE.view()).nodes().size();
+  }
+  const auto parseNs = nanosecondsSince(start) / parses;
+  sink = nodes;
+
+  std::mt19937 random(42);
+  std::vector<Assignment> assignments(1024);
+  for (auto &&assignment : assignments) {
+    assignment = {static_cast<std::uint32_t>(random()),
+                  static_cast<std::uint32_t>(random()),
+                  static_cast<std::uint32_t>(random())};
+  }
+
+  const Formula formula(RULE.view());
+  start = Clock::now();
+  std::size_t satisfied = 0;
+  for (std::size_t i = 0; i < evaluations; ++i) {
+    satisfied += formula.evaluate(assignments[i % assignments.size()]);
+  }
+  const auto runtimeNs = nanosecondsSince(start) / evaluations;
+
+  start = Clock::now();
+  std::size_t staticSatisfied = 0;
+  for (std::size_t i = 0; i < evaluations; ++i) {
+    staticSatisfied +=
+        StaticFormula<RULE>::evaluate(assignments[i % assignments.size()]);
+  }
+  const auto staticNs = nanosecondsSince(start) / evaluations;
+  sink = staticSatisfied;
+
+  if (satisfied != staticSatisfied) {
+    std::cerr << "Static formula result differs from the runtime one\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cout << std::fixed << std::setprecision(2) << "runtime parse: "
+            << parseNs << " ns per formula of " << RULE.view().size()
+            << " bytes\n"
+            << "runtime evaluation: " << runtimeNs << " ns\n"
+            << "static evaluation: " << staticNs << " ns ("
+            << runtimeNs / staticNs << "x)\n";
+}
@@ -0,0 +1,83 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#pragma once
+
+namespace benchmarks {
+
+struct GeneratorOptions {
+  std::uint64_t seed{42};
+  // Variables are the first letters of the alphabet, at most 26.
+  std::size_t variables{26};
+  // Maximum number of literals in a clause.
+  std::size_t clauseSize{6};
+  // Percentage of clauses written without spaces around parentheses.
+  std::size_t compact{50};
+  // Percentage of literals that are membership tests like `a in b`.
+  std::size_t membership{0};
+};
+
+// Seeded generator of machine-like formulas: disjunctions of parenthesized
+// conjunctions of possibly negated variables or membership tests.
+class FormulaGenerator {
+public:
+  explicit FormulaGenerator(GeneratorOptions options)
+      : _options(options), _random(options.seed) {}
+
+  std::string generate(std::size_t clauses) {
+    std::string formula;
+    for (std::size_t i = 0; i < clauses; ++i) {
+      clause(formula, i == 0);
+    }
+    return formula;
+  }
+
+  // Generates clauses until formula is at least `bytes` long.
+  std::string generateSize(std::size_t bytes) {
+    std::string formula;
+    formula.reserve(bytes + 256);
+    while (formula.size() < bytes) {
+      clause(formula, formula.empty());
+    }
+    return formula;
+  }
+
+private:
+  std::size_t pick(std::size_t bound) {
+    return std::uniform_int_distribution<std::size_t>(0, bound - 1)(_random);
+  }
+
+  char variable() { return static_cast<char>('a' + pick(_options.variables)); }
+
+  void clause(std::string &out, bool first) {
+    bool compact = pick(100) < _options.compact;
+    if (!first) {
+      out += compact ? "or" : " or ";
+    }
+    out += compact ? "(" : "( ";
+
+    auto literals = 1 + pick(_options.clauseSize);
+    for (std::size_t i = 0; i < literals; ++i) {
+      if (i != 0) {
+        out += " and ";
+      }
+      if (pick(3) == 0) {
+        out += "not ";
+      }
+      out += variable();
+      if (_options.membership != 0 && pick(100) < _options.membership) {
+        out += pick(2) == 0 ? " in " : " not in ";
+        out += variable();
+      }
+    }
+
+    out += compact ? ")" : " )";
+  }
+
+  GeneratorOptions _options;
+  std::mt19937_64 _random;
+};
+
+} // namespace benchmarks
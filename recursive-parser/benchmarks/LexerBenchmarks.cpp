@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ParallelLexer.h>
+
+#include "Generator.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  benchmarks::GeneratorOptions options;
+  std::size_t size = 256 * 1024 * 1024;
+  std::size_t maxJobs = std::max(1u, std::thread::hardware_concurrency());
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = std::stoull(arg.substr(arg.find('=') + 1));
+    if (arg.rfind("--seed=", 0) == 0) {
+      options.seed = value;
+    } else if (arg.rfind("--size=", 0) == 0) {
+      size = value;
+    } else if (arg.rfind("--jobs=", 0) == 0) {
+      maxJobs = value;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--seed=N] [--size=BYTES] [--jobs=N]\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  const auto formula = benchmarks::FormulaGenerator(options).generateSize(size);
+
+  auto start = Clock::now();
+  const auto expected = tokenize(formula);
+  const auto serialMs = millisecondsSince(start);
+
+  std::cout << "formula of " << formula.size() << " bytes, " << expected.size()
+            << " tokens\n"
+            << std::setw(8) << "jobs" << std::setw(12) << "ms"
+            << std::setw(12) << "MiB/s" << std::setw(10) << "speedup\n";
+  auto report = [&](const std::string &name, double ms) {
+    std::cout << std::setw(8) << name << std::fixed << std::setprecision(1)
+              << std::setw(12) << ms << std::setw(12)
+              << formula.size() / ms * 1000 / (1024 * 1024) << std::setw(9)
+              << std::setprecision(2) << serialMs / ms << std::endl;
+  };
+  report("serial", serialMs);
+
+  for (std::size_t jobs = 1; jobs <= maxJobs; jobs *= 2) {
+    start = Clock::now();
+    auto tokens = tokenizeParallel(formula, jobs);
+    report(std::to_string(jobs), millisecondsSince(start));
+    if (tokens != expected) {
+      std::cerr << "Parallel lexer result differs with " << jobs << " jobs\n";
+      return EXIT_FAILURE;
+    }
+  }
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <SyntaxAnalyzer.h>
+
+#include "Generator.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+SyntaxAnalyzer<StringViewSource> analyzer(std::string_view formula) {
+  return {LexicalAnalyzer<StringViewSource>{StringViewSource{formula}}};
+}
+
+// Counts variables, the only callback of the visitor.
+struct VariableCounter {
+  void token(Token token, char) { count += token == Token::VARIABLE; }
+
+  std::size_t count{};
+};
+
+// Keeps the compiler from dropping unused results.
+volatile std::size_t sink;
+
+template <typename Run>
+void measure(const std::string &name, std::size_t bytes, std::size_t repeats,
+             Run run) {
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < repeats; ++i) {
+    run();
+  }
+  auto ms = std::chrono::duration<double, std::milli>(Clock::now() - start)
+                .count() /
+            repeats;
+  std::cout << std::setw(10) << name << std::fixed << std::setprecision(3)
+            << std::setw(12) << ms << std::setw(12) << std::setprecision(1)
+            << bytes / ms * 1000 / (1024 * 1024) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  benchmarks::GeneratorOptions options;
+  std::size_t clauses = 2000;
+  std::size_t repeats = 100;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = std::stoull(arg.substr(arg.find('=') + 1));
+    if (arg.rfind("--seed=", 0) == 0) {
+      options.seed = value;
+    } else if (arg.rfind("--clauses=", 0) == 0) {
+      clauses = value;
+    } else if (arg.rfind("--repeats=", 0) == 0) {
+      repeats = value;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--seed=N] [--clauses=N] [--repeats=N]\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  const auto formula = benchmarks::FormulaGenerator(options).generate(clauses);
+  std::cout << "formula of " << formula.size() << " bytes\n"
+            << std::setw(10) << "mode" << std::setw(12) << "ms"
+            << std::setw(12) << "MiB/s" << '\n';
+
+  measure("tree", formula.size(), repeats,
+          [&] { sink = analyzer(formula).parse().children.size(); });
+  measure("validate", formula.size(), repeats,
+          [&] { analyzer(formula).validate(); });
+  measure("visitor", formula.size(), repeats, [&] {
+    VariableCounter counter;
+    analyzer(formula).parse(counter);
+    sink = counter.count;
+  });
+}
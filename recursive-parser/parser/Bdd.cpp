@@ -0,0 +1,274 @@
+#include "Bdd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr std::size_t MIN_UNIQUE_SIZE = 1 << 10;
+constexpr std::size_t MIN_CACHE_SIZE = 1 << 16;
+
+std::size_t hash(std::uint32_t a, std::uint32_t b, std::uint32_t c) noexcept {
+  std::uint64_t h = (std::uint64_t(b) << 32 | c) ^ a * 0x9e3779b97f4a7c15ull;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  return h;
+}
+
+} // namespace
+
+BddManager::BddManager(std::string_view order)
+    : _nodes{{ATOMS, FALSE, FALSE}, {ATOMS, TRUE, TRUE}},
+      _unique(MIN_UNIQUE_SIZE, FALSE), _cache(MIN_CACHE_SIZE) {
+  bool used[VARIABLES]{};
+  std::uint32_t position = 0;
+  auto place = [&](char variable) {
+    used[variable - 'a'] = true;
+    _position[variable - 'a'] = position;
+    _variable[position++] = variable;
+  };
+
+  for (auto variable : order) {
+    if (variable < 'a' || variable > 'z' || used[variable - 'a']) {
+      throw std::invalid_argument("Invalid variable order: " +
+                                  std::string(order));
+    }
+    place(variable);
+  }
+  for (char variable = 'a'; variable <= 'z'; ++variable) {
+    if (!used[variable - 'a']) {
+      place(variable);
+    }
+  }
+}
+
+BddManager::Node BddManager::compile(const Formula &formula) {
+  return compile(formula.nodes());
+}
+
+BddManager::Node BddManager::compile(const std::vector<FormulaNode> &nodes) {
+  std::vector<Node> results(nodes.size());
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    const auto &node = nodes[i];
+    switch (node.operation) {
+    case Operation::VARIABLE:
+      results[i] = value(node.variable);
+      break;
+    case Operation::NOT:
+      results[i] = negate(results[node.left]);
+      break;
+    case Operation::AND:
+    case Operation::OR:
+    case Operation::XOR:
+      results[i] =
+          apply(node.operation, results[node.left], results[node.right]);
+      break;
+    case Operation::IN:
+    case Operation::NOT_IN: {
+      auto element = results[node.left];
+      auto test = apply(
+          Operation::OR,
+          apply(Operation::AND, element, contains(node.variable, true)),
+          apply(Operation::AND, negate(element),
+                contains(node.variable, false)));
+      results[i] = node.operation == Operation::IN ? test : negate(test);
+      break;
+    }
+    }
+  }
+  return results.empty() ? FALSE : results.back();
+}
+
+BddManager::Node BddManager::value(char variable) {
+  return atom(3 * _position[variable - 'a']);
+}
+
+BddManager::Node BddManager::contains(char set, bool element) {
+  return atom(3 * _position[set - 'a'] + 1 + element);
+}
+
+BddManager::Node BddManager::negate(Node node) {
+  if (node <= TRUE) {
+    return node ^ 1;
+  }
+
+  constexpr auto code = static_cast<std::uint32_t>(Operation::NOT);
+  if (auto entry = _cache[hash(code, node, 0) & (_cache.size() - 1)];
+      entry.operation == code && entry.left == node) {
+    return entry.result;
+  }
+
+  auto [level, low, high] = _nodes[node];
+  auto result = make(level, negate(low), negate(high));
+  // Cache might have grown meanwhile.
+  _cache[hash(code, node, 0) & (_cache.size() - 1)] = {code, node, 0, result};
+  return result;
+}
+
+BddManager::Node BddManager::apply(Operation operation, Node left,
+                                   Node right) {
+  switch (operation) {
+  case Operation::AND:
+    if (left == FALSE || right == FALSE) {
+      return FALSE;
+    }
+    if (left == TRUE || left == right) {
+      return right;
+    }
+    if (right == TRUE) {
+      return left;
+    }
+    break;
+  case Operation::OR:
+    if (left == TRUE || right == TRUE) {
+      return TRUE;
+    }
+    if (left == FALSE || left == right) {
+      return right;
+    }
+    if (right == FALSE) {
+      return left;
+    }
+    break;
+  case Operation::XOR:
+    if (left == right) {
+      return FALSE;
+    }
+    if (left <= TRUE) {
+      return left == FALSE ? right : negate(right);
+    }
+    if (right <= TRUE) {
+      return right == FALSE ? left : negate(left);
+    }
+    break;
+  default:
+    throw std::invalid_argument("Not a binary operation");
+  }
+
+  // All operations are commutative.
+  if (left > right) {
+    std::swap(left, right);
+  }
+  auto code = static_cast<std::uint32_t>(operation);
+  if (auto entry = _cache[hash(code, left, right) & (_cache.size() - 1)];
+      entry.operation == code && entry.left == left && entry.right == right) {
+    return entry.result;
+  }
+
+  auto [leftLevel, leftLow, leftHigh] = _nodes[left];
+  auto [rightLevel, rightLow, rightHigh] = _nodes[right];
+  auto top = std::min(leftLevel, rightLevel);
+  if (leftLevel != top) {
+    leftLow = leftHigh = left;
+  }
+  if (rightLevel != top) {
+    rightLow = rightHigh = right;
+  }
+  auto result = make(top, apply(operation, leftLow, rightLow),
+                     apply(operation, leftHigh, rightHigh));
+  _cache[hash(code, left, right) & (_cache.size() - 1)] = {code, left, right,
+                                                           result};
+  return result;
+}
+
+bool BddManager::evaluate(Node node,
+                          const Assignment &assignment) const noexcept {
+  while (node > TRUE) {
+    const auto &current = _nodes[node];
+    node = atomValue(current.level, assignment) ? current.high : current.low;
+  }
+  return node == TRUE;
+}
+
+double BddManager::satCount(Node node) const {
+  // Share of satisfying assignments, children have smaller indices than
+  // their parents.
+  std::vector<double> share(node + 1, -1);
+  share[FALSE] = 0;
+  share[TRUE] = 1;
+  std::vector<Node> stack{node};
+  while (!stack.empty()) {
+    auto current = stack.back();
+    auto [level, low, high] = _nodes[current];
+    if (share[current] >= 0) {
+      stack.pop_back();
+    } else if (share[low] < 0) {
+      stack.push_back(low);
+    } else if (share[high] < 0) {
+      stack.push_back(high);
+    } else {
+      share[current] = (share[low] + share[high]) / 2;
+      stack.pop_back();
+    }
+  }
+  return std::ldexp(share[node], ATOMS);
+}
+
+std::size_t BddManager::memoryUsage() const noexcept {
+  return _nodes.capacity() * sizeof(BddNode) +
+         _unique.capacity() * sizeof(Node) +
+         _cache.capacity() * sizeof(CacheEntry);
+}
+
+BddManager::Node BddManager::atom(std::uint32_t level) {
+  return make(level, FALSE, TRUE);
+}
+
+BddManager::Node BddManager::make(std::uint32_t level, Node low, Node high) {
+  if (low == high) {
+    return low;
+  }
+
+  auto mask = _unique.size() - 1;
+  auto index = hash(level, low, high) & mask;
+  for (; _unique[index] != FALSE; index = (index + 1) & mask) {
+    const auto &node = _nodes[_unique[index]];
+    if (node.level == level && node.low == low && node.high == high) {
+      return _unique[index];
+    }
+  }
+
+  Node node = _nodes.size();
+  _nodes.push_back({level, low, high});
+  _unique[index] = node;
+  if (_nodes.size() * 2 > _unique.size()) {
+    grow();
+  }
+  return node;
+}
+
+void BddManager::grow() {
+  std::vector<Node> unique(_unique.size() * 2, FALSE);
+  auto mask = unique.size() - 1;
+  for (Node node = TRUE + 1; node < _nodes.size(); ++node) {
+    auto [level, low, high] = _nodes[node];
+    auto index = hash(level, low, high) & mask;
+    while (unique[index] != FALSE) {
+      index = (index + 1) & mask;
+    }
+    unique[index] = node;
+  }
+  _unique = std::move(unique);
+
+  // Results are kept in cache as long as they fit into it.
+  if (_cache.size() < _nodes.size()) {
+    _cache.assign(_cache.size() * 2, {});
+  }
+}
+
+bool BddManager::atomValue(std::uint32_t level,
+                           const Assignment &assignment) const noexcept {
+  auto variable = _variable[level / 3];
+  switch (level % 3) {
+  case 0:
+    return assignment.value(variable);
+  case 1:
+    return assignment.contains(variable, false);
+  default:
+    return assignment.contains(variable, true);
+  }
+}
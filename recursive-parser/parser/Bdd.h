@@ -0,0 +1,77 @@
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "Formula.h"
+
+#pragma once
+
+// Reduced ordered binary decision diagrams of formulas. Every variable is
+// described by three atoms: its value and whether it contains `false` and
+// `true` as a set, the atoms of one variable are adjacent in the order.
+// Nodes are never freed, equal formulas compiled by the same manager are the
+// same node.
+class BddManager {
+public:
+  using Node = std::uint32_t;
+
+  static constexpr Node FALSE = 0;
+  static constexpr Node TRUE = 1;
+  static constexpr std::size_t VARIABLES = 26;
+  static constexpr std::size_t ATOMS = 3 * VARIABLES;
+
+  // Variables in `order` come first, the rest follow alphabetically. Throws
+  // `std::invalid_argument` if `order` is not a sequence of distinct letters.
+  explicit BddManager(std::string_view order = {});
+
+  Node compile(const Formula &formula);
+  Node compile(const std::vector<FormulaNode> &nodes);
+
+  Node value(char variable);
+  Node contains(char set, bool element);
+
+  Node negate(Node node);
+  Node apply(Operation operation, Node left, Node right);
+
+  bool evaluate(Node node, const Assignment &assignment) const noexcept;
+
+  // Number of satisfying assignments of all `ATOMS` atoms.
+  double satCount(Node node) const;
+
+  // Nodes including both terminals.
+  std::size_t size() const noexcept { return _nodes.size(); }
+  std::size_t memoryUsage() const noexcept;
+
+private:
+  struct BddNode {
+    std::uint32_t level;
+    Node low;
+    Node high;
+  };
+
+  struct CacheEntry {
+    std::uint32_t operation;
+    Node left;
+    Node right;
+    Node result;
+  };
+
+  Node atom(std::uint32_t level);
+  Node make(std::uint32_t level, Node low, Node high);
+  void grow();
+
+  std::uint32_t level(Node node) const noexcept { return _nodes[node].level; }
+  bool atomValue(std::uint32_t level,
+                 const Assignment &assignment) const noexcept;
+
+  std::vector<BddNode> _nodes;
+  // Open addressing over node indices, `FALSE` marks empty bucket.
+  std::vector<Node> _unique;
+  // Direct mapped, entries are overwritten on collisions.
+  std::vector<CacheEntry> _cache;
+  // Position of every variable in the order.
+  std::uint32_t _position[VARIABLES]{};
+  // Variable of every position.
+  char _variable[VARIABLES]{};
+};
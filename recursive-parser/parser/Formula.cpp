@@ -0,0 +1,24 @@
+#include "Formula.h"
+
+bool Formula::evaluate(std::size_t index,
+                       const Assignment &assignment) const noexcept {
+  const auto &node = _nodes[index];
+  switch (node.operation) {
+  case Operation::VARIABLE:
+    return assignment.value(node.variable);
+  case Operation::NOT:
+    return !evaluate(node.left, assignment);
+  case Operation::AND:
+    return evaluate(node.left, assignment) && evaluate(node.right, assignment);
+  case Operation::OR:
+    return evaluate(node.left, assignment) || evaluate(node.right, assignment);
+  case Operation::XOR:
+    return evaluate(node.left, assignment) != evaluate(node.right, assignment);
+  case Operation::IN:
+    return assignment.contains(node.variable, evaluate(node.left, assignment));
+  case Operation::NOT_IN:
+    return !assignment.contains(node.variable,
+                                evaluate(node.left, assignment));
+  }
+  return false;
+}
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "LexicalAnalyzer.h"
+#include "SyntaxAnalyzer.h"
+#include "Token.h"
+
+#pragma once
+
+// Values of variables `a`..`z`, bit `i` describes variable `'a' + i`. Every
+// variable is a boolean and, on the right of `in`, a set of booleans.
+struct Assignment {
+  std::uint32_t values{};
+  std::uint32_t containsFalse{};
+  std::uint32_t containsTrue{};
+
+  constexpr bool value(char variable) const noexcept {
+    return values >> (variable - 'a') & 1;
+  }
+
+  constexpr bool contains(char set, bool element) const noexcept {
+    return (element ? containsTrue : containsFalse) >> (set - 'a') & 1;
+  }
+};
+
+enum class Operation { VARIABLE, NOT, AND, OR, XOR, IN, NOT_IN };
+
+// Node of a formula stored in postorder, `variable` is the name of
+// `VARIABLE` and the set of `IN` and `NOT_IN`, unary operations have only
+// `left` operand.
+struct FormulaNode {
+  Operation operation;
+  char variable;
+  std::size_t left;
+  std::size_t right;
+};
+
+// Visitor building formula nodes. Membership tests are chained as
+// in Python: `a in b not in c` is `a in b and b not in c`.
+class FormulaBuilder {
+public:
+  constexpr void enter(Nonterminal) { _frames.push_back(_items.size()); }
+
+  constexpr void token(Token token, char variable) {
+    _items.push_back({token, variable, {}});
+  }
+
+  constexpr void exit(Nonterminal nonterminal) {
+    auto start = _frames.back();
+    _frames.pop_back();
+
+    std::size_t node;
+    switch (nonterminal) {
+    case Nonterminal::E:
+      node = fold(start, Operation::OR);
+      break;
+    case Nonterminal::X:
+      node = fold(start, Operation::XOR);
+      break;
+    case Nonterminal::T:
+      node = fold(start, Operation::AND);
+      break;
+    case Nonterminal::N:
+      node = _items[start].token == Token::NOT_OPERATOR
+                 ? add(Operation::NOT, 0, _items[start + 1].node)
+                 : _items[start].node;
+      break;
+    case Nonterminal::M:
+      node = membership(start);
+      break;
+    case Nonterminal::F:
+      node = _items[start].token == Token::LP
+                 ? _items[start + 1].node
+                 : add(Operation::VARIABLE, _items[start].variable);
+      break;
+    default:
+      // Continuations and sets stay in the items of the parent.
+      return;
+    }
+
+    _items.resize(start);
+    _items.push_back({Token::END, 0, node});
+  }
+
+  // Nodes in postorder, the root is the last one.
+  constexpr std::vector<FormulaNode> result() && { return std::move(_nodes); }
+
+private:
+  // Matched token or, if it is `END`, node built for a nonterminal.
+  struct Item {
+    Token token;
+    char variable;
+    std::size_t node;
+  };
+
+  constexpr std::size_t add(Operation operation, char variable,
+                            std::size_t left = 0, std::size_t right = 0) {
+    _nodes.push_back({operation, variable, left, right});
+    return _nodes.size() - 1;
+  }
+
+  // Items are operands separated by operators.
+  constexpr std::size_t fold(std::size_t start, Operation operation) {
+    auto node = _items[start].node;
+    for (auto i = start + 1; i < _items.size(); i += 2) {
+      node = add(operation, 0, node, _items[i + 1].node);
+    }
+    return node;
+  }
+
+  // Items are operand followed by `[not] in set` tests.
+  constexpr std::size_t membership(std::size_t start) {
+    auto element = _items[start].node;
+    auto result = element;
+    char set = 0;
+    for (auto i = start + 1; i < _items.size(); i += 2) {
+      auto operation = Operation::IN;
+      if (_items[i].token == Token::NOT_OPERATOR) {
+        operation = Operation::NOT_IN;
+        ++i;
+      }
+      if (set != 0) {
+        element = add(Operation::VARIABLE, set);
+      }
+      auto test = add(operation, _items[i + 1].variable, element);
+      result = set != 0 ? add(Operation::AND, 0, result, test) : test;
+      set = _items[i + 1].variable;
+    }
+    return result;
+  }
+
+  std::vector<FormulaNode> _nodes;
+  std::vector<Item> _items;
+  std::vector<std::size_t> _frames;
+};
+
+// Parses formula into nodes, invalid formula throws `AnalysisException`.
+constexpr std::vector<FormulaNode> compileFormula(std::string_view text) {
+  SyntaxAnalyzer<StringViewSource> analyzer{
+      LexicalAnalyzer<StringViewSource>{StringViewSource{text}}};
+  FormulaBuilder builder;
+  analyzer.parse(builder);
+  return std::move(builder).result();
+}
+
+// Formula parsed at runtime.
+class Formula {
+public:
+  explicit Formula(std::string_view text) : _nodes(compileFormula(text)) {}
+
+  bool evaluate(const Assignment &assignment) const noexcept {
+    return evaluate(_nodes.size() - 1, assignment);
+  }
+
+  const std::vector<FormulaNode> &nodes() const noexcept { return _nodes; }
+
+private:
+  bool evaluate(std::size_t index, const Assignment &assignment) const noexcept;
+
+  std::vector<FormulaNode> _nodes;
+};
+
+// Expressions of formulas parsed at compile time.
+
+template <char Variable> struct Var {
+  static constexpr bool evaluate(const Assignment &assignment) noexcept {
+    return assignment.value(Variable);
+  }
+};
+
+template <typename Operand> struct Not {
+  static constexpr bool evaluate(const Assignment &assignment) noexcept {
+    return !Operand::evaluate(assignment);
+  }
+};
+
+template <typename Left, typename Right> struct And {
+  static constexpr bool evaluate(const Assignment &assignment) noexcept {
+    return Left::evaluate(assignment) && Right::evaluate(assignment);
+  }
+};
+
+template <typename Left, typename Right> struct Or {
+  static constexpr bool evaluate(const Assignment &assignment) noexcept {
+    return Left::evaluate(assignment) || Right::evaluate(assignment);
+  }
+};
+
+template <typename Left, typename Right> struct Xor {
+  static constexpr bool evaluate(const Assignment &assignment) noexcept {
+    return Left::evaluate(assignment) != Right::evaluate(assignment);
+  }
+};
+
+template <typename Element, char Set, bool Negated = false> struct In {
+  static constexpr bool evaluate(const Assignment &assignment) noexcept {
+    return assignment.contains(Set, Element::evaluate(assignment)) != Negated;
+  }
+};
+
+template <std::size_t N> struct FixedString {
+  constexpr FixedString(const char (&text)[N]) {
+    std::copy_n(text, N, data);
+  }
+
+  constexpr std::string_view view() const noexcept { return {data, N - 1}; }
+
+  char data[N]{};
+};
+
+template <std::size_t N> struct FlatFormula {
+  std::array<FormulaNode, N> nodes;
+};
+
+template <FixedString Text> constexpr auto flatFormula() {
+  constexpr auto size = compileFormula(Text.view()).size();
+  FlatFormula<size> formula{};
+  auto nodes = compileFormula(Text.view());
+  std::copy(nodes.begin(), nodes.end(), formula.nodes.begin());
+  return formula;
+}
+
+template <auto Flat, std::size_t Index> constexpr auto expression() {
+  constexpr auto node = Flat.nodes[Index];
+  if constexpr (node.operation == Operation::VARIABLE) {
+    return Var<node.variable>{};
+  } else if constexpr (node.operation == Operation::NOT) {
+    return Not<decltype(expression<Flat, node.left>())>{};
+  } else if constexpr (node.operation == Operation::IN ||
+                       node.operation == Operation::NOT_IN) {
+    return In<decltype(expression<Flat, node.left>()), node.variable,
+              node.operation == Operation::NOT_IN>{};
+  } else {
+    using Left = decltype(expression<Flat, node.left>());
+    using Right = decltype(expression<Flat, node.right>());
+    if constexpr (node.operation == Operation::AND) {
+      return And<Left, Right>{};
+    } else if constexpr (node.operation == Operation::OR) {
+      return Or<Left, Right>{};
+    } else {
+      return Xor<Left, Right>{};
+    }
+  }
+}
+
+// Expression type of formula parsed at compile time, invalid formula does
+// not compile.
+template <FixedString Text>
+using StaticFormula = decltype(expression<flatFormula<Text>(),
+                                          flatFormula<Text>().nodes.size() -
+                                              1>());
@@ -1,8 +1,9 @@
-#include <cctype>
 #include <cstddef>
 #include <istream>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "AnalysisExcpetion.h"
@@ -13,6 +14,12 @@
 using char_t = std::char_traits<char>::int_type;
 constexpr auto END_CHAR = std::char_traits<char>::eof();
 
+// Same characters as `std::isspace` in the "C" locale.
+constexpr bool isSpace(char_t ch) noexcept {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\v' || ch == '\f' ||
+         ch == '\r';
+}
+
 template <typename T>
 concept char_source = requires(T cs) {
   { cs.pos() } -> std::same_as<std::size_t>;
@@ -23,25 +30,66 @@ concept char_source = requires(T cs) {
 
 class StringSource {
 public:
-  StringSource(std::string str) : _str(std::move(str)) {}
+  constexpr StringSource(std::string str) { take(std::move(str)); }
+  constexpr StringSource(const StringSource &) = default;
+  constexpr StringSource(StringSource &&other) noexcept
+      : _pos(other._pos), _anchor(other._anchor) {
+    take(std::move(other._str));
+  }
+  constexpr StringSource &operator=(const StringSource &) = default;
+  constexpr StringSource &operator=(StringSource &&) noexcept = default;
 
-  char_t next() {
+  constexpr char_t next() {
     if (_pos >= _str.length()) {
       return END_CHAR;
     }
     return _str[_pos++];
   }
 
-  void setAnchor() { _anchor = _pos; }
-  void resetToAnchor() { _pos = _anchor; }
-  std::size_t pos() const noexcept { return _pos; }
+  constexpr void setAnchor() { _anchor = _pos; }
+  constexpr void resetToAnchor() { _pos = _anchor; }
+  constexpr std::size_t pos() const noexcept { return _pos; }
 
 private:
+  // GCC 12 fails to move short strings in constant evaluation.
+  constexpr void take(std::string &&str) {
+    if (std::is_constant_evaluated()) {
+      _str.assign(str.data(), str.size());
+    } else {
+      _str = std::move(str);
+    }
+  }
+
   std::string _str;
   std::size_t _pos{};
   std::size_t _anchor{};
 };
 
+// Source over a part of a larger buffer, positions are counted from the
+// beginning of that buffer.
+class StringViewSource {
+public:
+  constexpr StringViewSource(std::string_view str, std::size_t offset = 0)
+      : _str(str), _offset(offset) {}
+
+  constexpr char_t next() {
+    if (_pos >= _str.length()) {
+      return END_CHAR;
+    }
+    return _str[_pos++];
+  }
+
+  constexpr void setAnchor() { _anchor = _pos; }
+  constexpr void resetToAnchor() { _pos = _anchor; }
+  constexpr std::size_t pos() const noexcept { return _offset + _pos; }
+
+private:
+  std::string_view _str;
+  std::size_t _offset{};
+  std::size_t _pos{};
+  std::size_t _anchor{};
+};
+
 class StreamSource {
 public:
   StreamSource(std::istream *input) : _input(input) {}
@@ -81,35 +129,40 @@ private:
 };
 
 static_assert(char_source<StringSource>);
+static_assert(char_source<StringViewSource>);
 static_assert(char_source<StreamSource>);
 
 template <char_source CS> class LexicalAnalyzer {
 public: // Public interface
-  LexicalAnalyzer(CS cs) noexcept : _cs(std::move(cs)) { take(); }
+  constexpr LexicalAnalyzer(CS cs) noexcept : _cs(std::move(cs)) { take(); }
 
-  Token nextToken() {
+  constexpr Token nextToken() {
     skipSpaces();
 
     if (testIsEnd()) {
       _currentToken = Token::END;
     } else if (auto tokenResult = testTokens()) {
       _currentToken = *tokenResult;
-    } else {
+    } else if (testIsVariable()) {
       _currentToken = Token::VARIABLE;
-      take();
+      _variable = static_cast<char>(take());
+    } else {
+      throw AnalysisException(std::string(1, _currentChar), _cs.pos());
     }
 
     testTokenEnd();
     return currentToken();
   }
 
-  Token currentToken() const noexcept { return _currentToken; }
+  constexpr Token currentToken() const noexcept { return _currentToken; }
 
-  std::size_t pos() const noexcept { return _cs.pos(); }
+  // Name of the last read variable.
+  constexpr char variable() const noexcept { return _variable; }
+
+  constexpr std::size_t pos() const noexcept { return _cs.pos(); }
 
 private: // Helper method
-  std::optional<Token> testTokens() {
-    // TODO: Convert to compile-time hashmap
+  constexpr std::optional<Token> testTokens() {
     for (auto &&[tokenString, token] : stringToToken) {
       auto &&[success, _] = test(tokenString);
       if (success) {
@@ -121,20 +174,20 @@ private: // Helper method
   }
 
 private: // Common methods
-  char_t take() {
+  constexpr char_t take() {
     auto taken = _currentChar;
     _currentChar = _cs.next();
     return taken;
   }
 
-  void take(const std::string &expected) {
+  constexpr void take(std::string_view expected) {
     auto &&[success, result] = test(expected, false);
     if (!success) {
-      throw AnalysisException(expected, result, _cs.pos());
+      throw AnalysisException(std::string(expected), result, _cs.pos());
     }
   }
 
-  void testTokenEnd() {
+  constexpr void testTokenEnd() {
     if (_currentToken == Token::LP || _currentToken == Token::RP) {
       return;
     }
@@ -147,12 +200,17 @@ private: // Common methods
     }
   }
 
-  bool testIsEnd() const noexcept { return _currentChar == END_CHAR; }
-  bool testIsSpace() const noexcept { return std::isspace(_currentChar); }
-  bool test(char expected) const noexcept { return expected == _currentChar; }
+  constexpr bool testIsEnd() const noexcept { return _currentChar == END_CHAR; }
+  constexpr bool testIsSpace() const noexcept { return isSpace(_currentChar); }
+  constexpr bool testIsVariable() const noexcept {
+    return 'a' <= _currentChar && _currentChar <= 'z';
+  }
+  constexpr bool test(char expected) const noexcept {
+    return expected == _currentChar;
+  }
 
-  std::pair<bool, std::string> test(const std::string &expected,
-                                    bool useAnchor = true) {
+  constexpr std::pair<bool, std::string> test(std::string_view expected,
+                                              bool useAnchor = true) {
     auto anchorChar = _currentChar;
     if (useAnchor) {
       _cs.setAnchor();
@@ -174,7 +232,7 @@ private: // Common methods
     return {success, result};
   }
 
-  void skipSpaces() {
+  constexpr void skipSpaces() {
     while (!testIsEnd() && testIsSpace()) {
       take();
     }
@@ -182,10 +240,11 @@ private: // Common methods
 
 private: // Data
   CS _cs;
-  char_t _currentChar;
-  Token _currentToken;
+  char_t _currentChar{};
+  Token _currentToken{Token::END};
+  char _variable{};
 
-  static constexpr std::pair<std::string, Token> stringToToken[] = {
+  static constexpr std::pair<std::string_view, Token> stringToToken[] = {
       {"or", Token::OR_OPERATOR},
       {"xor", Token::XOR_OPERATOR},
       {"and", Token::AND_OPERATOR},
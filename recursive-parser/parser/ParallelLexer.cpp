@@ -0,0 +1,118 @@
+#include "ParallelLexer.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include "LexicalAnalyzer.h"
+
+namespace {
+
+// Smaller chunks are not worth a thread.
+constexpr std::size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+bool isParenthesis(char ch) { return ch == '(' || ch == ')'; }
+
+// Tokens never continue past these characters, so lexing can restart right
+// after any of them.
+bool isBoundary(char ch) {
+  return isSpace(ch) || isParenthesis(ch);
+}
+
+// Lexes `text[begin, end)`, where `end` is the text end or follows a
+// boundary character. `END` token is appended only for the last chunk.
+void lexChunk(std::string_view text, std::size_t begin, std::size_t end,
+              Tokens &out) {
+  LexicalAnalyzer<StringViewSource> lexer(
+      StringViewSource(text.substr(begin, end - begin), begin));
+  for (;;) {
+    auto token = lexer.nextToken();
+    if (token == Token::END && end != text.size()) {
+      break;
+    }
+    out.push_back({token, lexer.pos()});
+    if (token == Token::END) {
+      return;
+    }
+  }
+
+  // Lexer of the whole text would have read the character after trailing
+  // parenthesis instead of hitting the chunk end.
+  if (!out.empty() && isParenthesis(text[end - 1])) {
+    out.back().pos = end + 1;
+  }
+}
+
+// Splits text into at most `count` chunks, returns their ends.
+std::vector<std::size_t> split(std::string_view text, std::size_t count) {
+  std::vector<std::size_t> ends;
+  std::size_t end = 0;
+  for (std::size_t i = 1; i < count; ++i) {
+    auto target = std::max(end, text.size() / count * i);
+    auto boundary = std::find_if(text.begin() + target, text.end(), isBoundary);
+    if (boundary == text.end()) {
+      break;
+    }
+    end = boundary - text.begin() + 1;
+    ends.push_back(end);
+  }
+  if (ends.empty() || ends.back() != text.size()) {
+    ends.push_back(text.size());
+  }
+  return ends;
+}
+
+} // namespace
+
+Tokens tokenize(std::string_view text) {
+  Tokens tokens;
+  lexChunk(text, 0, text.size(), tokens);
+  return tokens;
+}
+
+Tokens tokenizeParallel(std::string_view text, std::size_t jobs) {
+  if (jobs == 0) {
+    jobs = std::max(1u, std::thread::hardware_concurrency());
+  }
+  jobs = std::min(jobs, text.size() / MIN_CHUNK_SIZE);
+  if (jobs <= 1) {
+    return tokenize(text);
+  }
+
+  auto ends = split(text, jobs);
+  std::vector<Tokens> chunks(ends.size());
+  std::vector<std::exception_ptr> errors(ends.size());
+  {
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0; i < ends.size(); ++i) {
+      threads.emplace_back([&, i] {
+        try {
+          lexChunk(text, i == 0 ? 0 : ends[i - 1], ends[i], chunks[i]);
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      });
+    }
+  }
+
+  // Serial lexer would stop at the first error.
+  for (auto &&error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // Reserved memory is committed only as tokens are appended and every chunk
+  // is freed right after it, so at most one chunk is held twice.
+  std::size_t total = 0;
+  for (auto &&chunk : chunks) {
+    total += chunk.size();
+  }
+  Tokens tokens;
+  tokens.reserve(total);
+  for (auto &&chunk : chunks) {
+    tokens.insert(tokens.end(), chunk.begin(), chunk.end());
+    Tokens().swap(chunk);
+  }
+  return tokens;
+}
@@ -0,0 +1,24 @@
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "Token.h"
+
+#pragma once
+
+// Token with position reported by the lexer right after reading it.
+struct PositionedToken {
+  Token token;
+  std::size_t pos;
+
+  bool operator==(const PositionedToken &) const = default;
+};
+using Tokens = std::vector<PositionedToken>;
+
+// Lexes whole text on the calling thread, result ends with `Token::END`.
+Tokens tokenize(std::string_view text);
+
+// Lexes text split into chunks at whitespaces and parentheses on `jobs`
+// threads (hardware concurrency if zero). Result and thrown errors are the
+// same as of `tokenize`.
+Tokens tokenizeParallel(std::string_view text, std::size_t jobs = 0);
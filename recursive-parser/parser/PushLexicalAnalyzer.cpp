@@ -0,0 +1,53 @@
+#include "PushLexicalAnalyzer.h"
+
+#include "LexicalAnalyzer.h"
+
+namespace {
+
+// The longest keyword and the character after it, the lexer never looks
+// further from the token start.
+constexpr std::size_t LOOKAHEAD = 4;
+
+std::size_t length(Token token) noexcept {
+  switch (token) {
+  case Token::OR_OPERATOR:
+  case Token::IN_OPERATOR:
+    return 2;
+  case Token::XOR_OPERATOR:
+  case Token::AND_OPERATOR:
+  case Token::NOT_OPERATOR:
+    return 3;
+  case Token::END:
+    return 0;
+  default:
+    return 1;
+  }
+}
+
+} // namespace
+
+void PushLexicalAnalyzer::feed(std::string_view chunk) {
+  _buffer.erase(0, _begin);
+  _offset += _begin;
+  _begin = 0;
+  _buffer.append(chunk);
+}
+
+std::optional<Token> PushLexicalAnalyzer::nextToken() {
+  while (_begin < _buffer.size() && isSpace(_buffer[_begin])) {
+    ++_begin;
+  }
+  if (!_finished && _buffer.size() - _begin < LOOKAHEAD) {
+    return {};
+  }
+
+  LexicalAnalyzer<StringViewSource> lexer(StringViewSource(
+      std::string_view(_buffer).substr(_begin), _offset + _begin));
+  auto token = lexer.nextToken();
+  if (token == Token::VARIABLE) {
+    _variable = lexer.variable();
+  }
+  _pos = lexer.pos();
+  _begin += length(token);
+  return token;
+}
@@ -0,0 +1,41 @@
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Token.h"
+
+#pragma once
+
+// Lexer fed with input chunks as they arrive instead of pulling characters
+// from a source. Tokens, positions and errors are the same as of
+// `LexicalAnalyzer` over the whole input.
+class PushLexicalAnalyzer {
+public:
+  // Appends next chunk of the input.
+  void feed(std::string_view chunk);
+
+  // Marks the end of the input, no chunks may follow.
+  void finish() noexcept { _finished = true; }
+
+  // Reads the next token, or returns nothing if more input is needed to tell
+  // it. Throws `AnalysisException` on invalid input.
+  std::optional<Token> nextToken();
+
+  // Name of the last read variable.
+  char variable() const noexcept { return _variable; }
+
+  // Same as `LexicalAnalyzer::pos` after the last read token.
+  std::size_t pos() const noexcept { return _pos; }
+
+private:
+  // Unread input starts at `_buffer[_begin]`, which is `_offset + _begin`
+  // in the whole input.
+  std::string _buffer;
+  std::size_t _begin{};
+  std::size_t _offset{};
+  bool _finished{};
+
+  char _variable{};
+  std::size_t _pos{};
+};
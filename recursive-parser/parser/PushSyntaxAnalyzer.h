@@ -0,0 +1,235 @@
+#include <concepts>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "AnalysisExcpetion.h"
+#include "PushLexicalAnalyzer.h"
+#include "SyntaxAnalyzer.h"
+#include "Token.h"
+
+#pragma once
+
+enum class PushStatus { NEED_MORE_INPUT, DONE };
+
+// Parser fed with input chunks, e.g. as they are read from a non-blocking
+// socket. Recursion of `SyntaxAnalyzer` is replaced by an explicit stack, so
+// parsing stops wherever the buffered input ends and resumes on the next
+// chunk. Visitor receives the same events in the same order, errors are the
+// same `AnalysisException` and are thrown as soon as they are detected.
+template <typename V = TreeBuilder> class PushSyntaxAnalyzer {
+public:
+  explicit PushSyntaxAnalyzer(V visitor = {}) : _visitor(std::move(visitor)) {
+    push({{Step::PARSE, Nonterminal::E}, {Step::EXPECT_END}});
+  }
+
+  PushStatus feed(std::string_view chunk) {
+    _lexer.feed(chunk);
+    return run();
+  }
+
+  // Marks the end of the input, always returns `PushStatus::DONE`.
+  PushStatus finish() {
+    _lexer.finish();
+    return run();
+  }
+
+  V &visitor() noexcept { return _visitor; }
+
+  NameASTNode result() &&
+    requires std::same_as<V, TreeBuilder>
+  {
+    return std::move(_visitor).result();
+  }
+
+private:
+  enum class Step { PARSE, EXIT, MATCH, EXPECT_END };
+
+  struct Item {
+    Step step;
+    Nonterminal nonterminal{};
+    Token token{};
+  };
+
+  // Pushes items so that the first of them is on the top.
+  void push(std::initializer_list<Item> items) {
+    _stack.insert(_stack.end(), std::rbegin(items), std::rend(items));
+  }
+
+  PushStatus run() {
+    while (!_stack.empty()) {
+      // `SyntaxAnalyzer` reads the next token right after matching one.
+      if (!_current && !(_current = _lexer.nextToken())) {
+        return PushStatus::NEED_MORE_INPUT;
+      }
+
+      auto item = _stack.back();
+      _stack.pop_back();
+      switch (item.step) {
+      case Step::PARSE:
+        parse(item.nonterminal);
+        break;
+      case Step::EXIT:
+        visitExit(_visitor, item.nonterminal);
+        break;
+      case Step::MATCH:
+        if (!match(item.token)) {
+          error();
+        }
+        break;
+      case Step::EXPECT_END:
+        if (*_current != Token::END) {
+          error();
+        }
+        break;
+      }
+    }
+    return PushStatus::DONE;
+  }
+
+  // One call of the corresponding `SyntaxAnalyzer::parse*` up to its first
+  // recursive call, the rest is pushed to the stack.
+  void parse(Nonterminal nonterminal) {
+    switch (nonterminal) {
+    case Nonterminal::E:
+      expand(nonterminal, {Token::NOT_OPERATOR, Token::LP, Token::VARIABLE},
+             Nonterminal::X, Nonterminal::E_PRIME);
+      break;
+    case Nonterminal::X:
+      expand(nonterminal, {Token::NOT_OPERATOR, Token::LP, Token::VARIABLE},
+             Nonterminal::T, Nonterminal::X_PRIME);
+      break;
+    case Nonterminal::T:
+      expand(nonterminal, {Token::NOT_OPERATOR, Token::LP, Token::VARIABLE},
+             Nonterminal::N, Nonterminal::T_PRIME);
+      break;
+    case Nonterminal::M:
+      expand(nonterminal, {Token::LP, Token::VARIABLE}, Nonterminal::F,
+             Nonterminal::M_PRIME);
+      break;
+
+    case Nonterminal::E_PRIME:
+      expandPrime(nonterminal, Token::OR_OPERATOR, Nonterminal::X,
+                  {Token::RP, Token::END});
+      break;
+    case Nonterminal::X_PRIME:
+      expandPrime(nonterminal, Token::XOR_OPERATOR, Nonterminal::T,
+                  {Token::OR_OPERATOR, Token::RP, Token::END});
+      break;
+    case Nonterminal::T_PRIME:
+      expandPrime(nonterminal, Token::AND_OPERATOR, Nonterminal::N,
+                  {Token::XOR_OPERATOR, Token::OR_OPERATOR, Token::RP,
+                   Token::END});
+      break;
+
+    case Nonterminal::N:
+      visitEnter(_visitor, nonterminal);
+      if (match(Token::NOT_OPERATOR)) {
+        push({{Step::PARSE, Nonterminal::N}, {Step::EXIT, nonterminal}});
+      } else if (currentTokenIs({Token::LP, Token::VARIABLE})) {
+        push({{Step::PARSE, Nonterminal::M}, {Step::EXIT, nonterminal}});
+      } else {
+        error();
+      }
+      break;
+
+    case Nonterminal::M_PRIME:
+      visitEnter(_visitor, nonterminal);
+      if (match(Token::IN_OPERATOR)) {
+        push({{Step::PARSE, Nonterminal::S},
+              {Step::PARSE, nonterminal},
+              {Step::EXIT, nonterminal}});
+      } else if (match(Token::NOT_OPERATOR)) {
+        push({{Step::MATCH, {}, Token::IN_OPERATOR},
+              {Step::PARSE, Nonterminal::S},
+              {Step::PARSE, nonterminal},
+              {Step::EXIT, nonterminal}});
+      } else if (currentTokenIs({Token::AND_OPERATOR, Token::XOR_OPERATOR,
+                                 Token::OR_OPERATOR, Token::RP, Token::END})) {
+        visitExit(_visitor, nonterminal);
+      } else {
+        error();
+      }
+      break;
+
+    case Nonterminal::F:
+      visitEnter(_visitor, nonterminal);
+      if (match(Token::LP)) {
+        push({{Step::PARSE, Nonterminal::E},
+              {Step::MATCH, {}, Token::RP},
+              {Step::EXIT, nonterminal}});
+      } else if (match(Token::VARIABLE)) {
+        push({{Step::EXIT, nonterminal}});
+      } else {
+        error();
+      }
+      break;
+
+    case Nonterminal::S:
+      visitEnter(_visitor, nonterminal);
+      if (!match(Token::VARIABLE)) {
+        error();
+      }
+      push({{Step::EXIT, nonterminal}});
+      break;
+    }
+  }
+
+  // Nonterminal starting with one of `starts`, `first` followed by `rest`.
+  void expand(Nonterminal nonterminal, std::initializer_list<Token> starts,
+              Nonterminal first, Nonterminal rest) {
+    if (!currentTokenIs(starts)) {
+      error();
+    }
+    visitEnter(_visitor, nonterminal);
+    push({{Step::PARSE, first}, {Step::PARSE, rest}, {Step::EXIT, nonterminal}});
+  }
+
+  // Either `separator`, `operand` and the prime again or nothing if followed
+  // by one of `follow`.
+  void expandPrime(Nonterminal nonterminal, Token separator,
+                   Nonterminal operand, std::initializer_list<Token> follow) {
+    visitEnter(_visitor, nonterminal);
+    if (match(separator)) {
+      push({{Step::PARSE, operand},
+            {Step::PARSE, nonterminal},
+            {Step::EXIT, nonterminal}});
+    } else if (currentTokenIs(follow)) {
+      visitExit(_visitor, nonterminal);
+    } else {
+      error();
+    }
+  }
+
+  bool currentTokenIs(std::initializer_list<Token> either) const noexcept {
+    for (auto token : either) {
+      if (*_current == token) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Consumes current token if it is `expected`, the next one is read before
+  // anything else happens.
+  bool match(Token expected) {
+    if (*_current != expected) {
+      return false;
+    }
+    visitToken(_visitor, expected, _lexer.variable());
+    _current.reset();
+    return true;
+  }
+
+  [[noreturn]] void error() const {
+    throw AnalysisException(*_current, _lexer.pos());
+  }
+
+  PushLexicalAnalyzer _lexer;
+  std::optional<Token> _current;
+  std::vector<Item> _stack;
+  V _visitor;
+};
@@ -1,4 +1,5 @@
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -15,146 +16,242 @@ template <typename Meta = std::string> struct ASTNode {
 };
 using NameASTNode = ASTNode<>;
 
+enum class Nonterminal {
+  E,
+  E_PRIME,
+  X,
+  X_PRIME,
+  T,
+  T_PRIME,
+  N,
+  M,
+  M_PRIME,
+  F,
+  S
+};
+
+constexpr std::string_view name(Nonterminal nonterminal) noexcept {
+  constexpr std::string_view names[] = {"E", "E'", "X", "X'", "T", "T'",
+                                        "N", "M", "M'", "F", "S"};
+  return names[static_cast<std::size_t>(nonterminal)];
+}
+
+// Visitors receive parsing events through any of these members, missing ones
+// cost nothing:
+//   enter(Nonterminal)              before nonterminal is parsed;
+//   token(Token, char variable)     for every matched terminal, `variable` is
+//                                   the name of `Token::VARIABLE`;
+//   exit(Nonterminal)               after nonterminal is parsed.
+
+template <typename V>
+constexpr void visitEnter(V &visitor, Nonterminal nonterminal) {
+  if constexpr (requires { visitor.enter(nonterminal); }) {
+    visitor.enter(nonterminal);
+  }
+}
+
+template <typename V>
+constexpr void visitToken(V &visitor, Token token, char variable) {
+  if constexpr (requires { visitor.token(token, variable); }) {
+    visitor.token(token, variable);
+  }
+}
+
+template <typename V>
+constexpr void visitExit(V &visitor, Nonterminal nonterminal) {
+  if constexpr (requires { visitor.exit(nonterminal); }) {
+    visitor.exit(nonterminal);
+  }
+}
+
+// Visitor ignoring all events.
+struct Recognizer {};
+
+// Visitor building parse tree of nonterminals.
+class TreeBuilder {
+public:
+  constexpr void enter(Nonterminal nonterminal) {
+    _stack.push_back({std::string(name(nonterminal)), {}});
+  }
+
+  constexpr void exit(Nonterminal) {
+    auto node = std::move(_stack.back());
+    _stack.pop_back();
+    if (_stack.empty()) {
+      _root = std::move(node);
+    } else {
+      _stack.back().children.push_back(std::move(node));
+    }
+  }
+
+  constexpr NameASTNode result() && { return std::move(_root); }
+
+private:
+  std::vector<NameASTNode> _stack;
+  NameASTNode _root;
+};
+
 template <char_source CS> class SyntaxAnalyzer {
 public:
-  SyntaxAnalyzer(LexicalAnalyzer<CS> lexer) : _lexer(std::move(lexer)) {
+  constexpr SyntaxAnalyzer(LexicalAnalyzer<CS> lexer)
+      : _lexer(std::move(lexer)) {
     _lexer.nextToken();
   }
 
-  NameASTNode parse() {
-    auto result = parseE();
+  constexpr NameASTNode parse() {
+    TreeBuilder builder;
+    parse(builder);
+    return std::move(builder).result();
+  }
+
+  // Checks that the whole input is a formula without building anything,
+  // allocates only the thrown `AnalysisException`.
+  constexpr void validate() {
+    Recognizer recognizer;
+    parse(recognizer);
+  }
+
+  template <typename V> constexpr void parse(V &visitor) {
+    parseE(visitor);
     if (!currentTokenIs<Token::END>()) {
       error();
     }
-    return result;
   }
 
 private:
-  NameASTNode parseE() {
-    if (currentTokenIs<Token::NOT_OPERATOR, Token::LP, Token::VARIABLE>()) {
-      auto X = parseX();
-      auto Ep = parseEPrime();
-      return {"E", {X, Ep}};
+  template <typename V> constexpr void parseE(V &visitor) {
+    if (!currentTokenIs<Token::NOT_OPERATOR, Token::LP, Token::VARIABLE>()) {
+      error();
     }
-
-    error();
+    visitEnter(visitor, Nonterminal::E);
+    parseX(visitor);
+    parseEPrime(visitor);
+    visitExit(visitor, Nonterminal::E);
   }
 
-  NameASTNode parseEPrime() {
-    if (match<Token::OR_OPERATOR>()) {
-      return {"E'", {parseX(), parseEPrime()}};
-    } else if (currentTokenIs<Token::RP, Token::END>()) {
-      return {"E'"};
+  template <typename V> constexpr void parseEPrime(V &visitor) {
+    visitEnter(visitor, Nonterminal::E_PRIME);
+    if (match<Token::OR_OPERATOR>(visitor)) {
+      parseX(visitor);
+      parseEPrime(visitor);
+    } else if (!currentTokenIs<Token::RP, Token::END>()) {
+      error();
     }
-
-    error();
+    visitExit(visitor, Nonterminal::E_PRIME);
   }
 
-  NameASTNode parseX() {
-    if (currentTokenIs<Token::NOT_OPERATOR, Token::LP, Token::VARIABLE>()) {
-      auto T = parseT();
-      auto Xp = parseXPrime();
-      return {"X", {T, Xp}};
+  template <typename V> constexpr void parseX(V &visitor) {
+    if (!currentTokenIs<Token::NOT_OPERATOR, Token::LP, Token::VARIABLE>()) {
+      error();
     }
-
-    error();
+    visitEnter(visitor, Nonterminal::X);
+    parseT(visitor);
+    parseXPrime(visitor);
+    visitExit(visitor, Nonterminal::X);
   }
 
-  NameASTNode parseXPrime() {
-    if (match<Token::XOR_OPERATOR>()) {
-      return {"X'", {parseT(), parseXPrime()}};
-    } else if (currentTokenIs<Token::OR_OPERATOR, Token::RP, Token::END>()) {
-      return {"X'"};
+  template <typename V> constexpr void parseXPrime(V &visitor) {
+    visitEnter(visitor, Nonterminal::X_PRIME);
+    if (match<Token::XOR_OPERATOR>(visitor)) {
+      parseT(visitor);
+      parseXPrime(visitor);
+    } else if (!currentTokenIs<Token::OR_OPERATOR, Token::RP, Token::END>()) {
+      error();
     }
-
-    error();
+    visitExit(visitor, Nonterminal::X_PRIME);
   }
 
-  NameASTNode parseT() {
-    if (currentTokenIs<Token::NOT_OPERATOR, Token::LP, Token::VARIABLE>()) {
-      auto N = parseN();
-      auto Tp = parseTPrime();
-      return {"T", {N, Tp}};
+  template <typename V> constexpr void parseT(V &visitor) {
+    if (!currentTokenIs<Token::NOT_OPERATOR, Token::LP, Token::VARIABLE>()) {
+      error();
     }
-
-    error();
+    visitEnter(visitor, Nonterminal::T);
+    parseN(visitor);
+    parseTPrime(visitor);
+    visitExit(visitor, Nonterminal::T);
   }
 
-  NameASTNode parseTPrime() {
-    if (match<Token::AND_OPERATOR>()) {
-      return {"E'", {parseN(), parseTPrime()}};
-    } else if (currentTokenIs<Token::XOR_OPERATOR, Token::OR_OPERATOR,
-                              Token::RP, Token::END>()) {
-      return {"E'"};
+  template <typename V> constexpr void parseTPrime(V &visitor) {
+    visitEnter(visitor, Nonterminal::T_PRIME);
+    if (match<Token::AND_OPERATOR>(visitor)) {
+      parseN(visitor);
+      parseTPrime(visitor);
+    } else if (!currentTokenIs<Token::XOR_OPERATOR, Token::OR_OPERATOR,
+                               Token::RP, Token::END>()) {
+      error();
     }
-
-    error();
+    visitExit(visitor, Nonterminal::T_PRIME);
   }
 
-  NameASTNode parseN() {
-    if (match<Token::NOT_OPERATOR>()) {
-      return {"N", {parseN()}};
+  template <typename V> constexpr void parseN(V &visitor) {
+    visitEnter(visitor, Nonterminal::N);
+    if (match<Token::NOT_OPERATOR>(visitor)) {
+      parseN(visitor);
     } else if (currentTokenIs<Token::LP, Token::VARIABLE>()) {
-      return {"N", {parseM()}};
+      parseM(visitor);
+    } else {
+      error();
     }
-
-    error();
+    visitExit(visitor, Nonterminal::N);
   }
 
-  NameASTNode parseM() {
-    if (currentTokenIs<Token::LP, Token::VARIABLE>()) {
-      return {"M", {parseF(), parseMPrime()}};
+  template <typename V> constexpr void parseM(V &visitor) {
+    if (!currentTokenIs<Token::LP, Token::VARIABLE>()) {
+      error();
     }
-
-    error();
+    visitEnter(visitor, Nonterminal::M);
+    parseF(visitor);
+    parseMPrime(visitor);
+    visitExit(visitor, Nonterminal::M);
   }
 
-  NameASTNode parseMPrime() {
-    if (match<Token::IN_OPERATOR>()) {
-      return {"M'", {parseS(), parseMPrime()}};
-    } else if (match<Token::NOT_OPERATOR>()) {
-      if (match<Token::IN_OPERATOR>()) {
-        return {"M'", {parseS(), parseMPrime()}};
+  template <typename V> constexpr void parseMPrime(V &visitor) {
+    visitEnter(visitor, Nonterminal::M_PRIME);
+    if (match<Token::IN_OPERATOR>(visitor)) {
+      parseS(visitor);
+      parseMPrime(visitor);
+    } else if (match<Token::NOT_OPERATOR>(visitor)) {
+      if (!match<Token::IN_OPERATOR>(visitor)) {
+        error();
       }
+      parseS(visitor);
+      parseMPrime(visitor);
+    } else if (!currentTokenIs<Token::AND_OPERATOR, Token::XOR_OPERATOR,
+                               Token ::OR_OPERATOR, Token::RP, Token::END>()) {
       error();
-    } else if (currentTokenIs<Token::NOT_OPERATOR, Token::AND_OPERATOR,
-                              Token::XOR_OPERATOR, Token ::OR_OPERATOR,
-                              Token::RP, Token::END>()) {
-      return {"M'"};
     }
-
-    error();
+    visitExit(visitor, Nonterminal::M_PRIME);
   }
 
-  NameASTNode parseF() {
-    if (match<Token::LP>()) {
-      auto E = parseE();
-      if (!match<Token::RP>()) {
+  template <typename V> constexpr void parseF(V &visitor) {
+    visitEnter(visitor, Nonterminal::F);
+    if (match<Token::LP>(visitor)) {
+      parseE(visitor);
+      if (!match<Token::RP>(visitor)) {
         error();
       }
-      return {"F", {E}};
-    } else if (match<Token::VARIABLE>()) {
-      return {"F"};
+    } else if (!match<Token::VARIABLE>(visitor)) {
+      error();
     }
-
-    error();
+    visitExit(visitor, Nonterminal::F);
   }
 
-  NameASTNode parseS() {
-    if (_lexer.currentToken() == Token::VARIABLE) {
-      _lexer.nextToken();
-      return {"S"};
+  template <typename V> constexpr void parseS(V &visitor) {
+    visitEnter(visitor, Nonterminal::S);
+    if (!match<Token::VARIABLE>(visitor)) {
+      error();
     }
-
-    error();
+    visitExit(visitor, Nonterminal::S);
   }
 
-  template <Token... Either> bool currentTokenIs() noexcept {
+  template <Token... Either> constexpr bool currentTokenIs() const noexcept {
     return ((_lexer.currentToken() == Either) || ...);
   }
 
-  template <Token... Either> bool match() noexcept {
+  template <Token... Either, typename V>
+  constexpr bool match(V &visitor) {
     if (currentTokenIs<Either...>()) {
+      visitToken(visitor, _lexer.currentToken(), _lexer.variable());
       _lexer.nextToken();
       return true;
     }
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <Bdd.h>
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+class BddTest : public ::testing::Test {
+protected:
+  BddManager::Node compile(std::string_view formula) {
+    return manager.compile(Formula(formula));
+  }
+
+  static std::vector<Assignment> assignments(std::size_t count) {
+    std::mt19937 random(42);
+    std::vector<Assignment> result;
+    for (std::size_t i = 0; i < count; ++i) {
+      result.push_back({static_cast<std::uint32_t>(random()),
+                        static_cast<std::uint32_t>(random()),
+                        static_cast<std::uint32_t>(random())});
+    }
+    return result;
+  }
+
+  BddManager manager;
+};
+
+TEST_F(BddTest, Terminals) {
+  EXPECT_EQ(compile("a and not a"), BddManager::FALSE);
+  EXPECT_EQ(compile("a or not a"), BddManager::TRUE);
+  EXPECT_EQ(compile("a xor a"), BddManager::FALSE);
+  EXPECT_EQ(compile("(a in b) or (a not in b)"), BddManager::TRUE);
+}
+
+TEST_F(BddTest, Equivalence) {
+  EXPECT_EQ(compile("a and b"), compile("b and a"));
+  EXPECT_EQ(compile("not (a or b)"), compile("not a and not b"));
+  EXPECT_EQ(compile("a xor b"), compile("(a or b) and not (a and b)"));
+  EXPECT_EQ(compile("a in b in c"), compile("(a in b) and (b in c)"));
+  EXPECT_EQ(compile("a not in b"), compile("not (a in b)"));
+  EXPECT_NE(compile("a or b and c"), compile("(a or b) and c"));
+  EXPECT_NE(compile("a in b"), compile("b in a"));
+}
+
+TEST_F(BddTest, NodesAreShared) {
+  auto formula = "(a and not b) or (c xor d) in e not in f or not g";
+  auto node = compile(formula);
+  auto size = manager.size();
+  EXPECT_EQ(compile(formula), node);
+  EXPECT_EQ(manager.size(), size);
+}
+
+TEST_F(BddTest, SameAsFormula) {
+  for (auto text : {"a", "not a xor b or c and d",
+                    "(a or b) and not (c xor d) or e in f not in g",
+                    "((a in b) or (c not in d)) xor not not (e and f)",
+                    "(a in a) and (b not in b) or z in y in x"}) {
+    Formula formula(text);
+    auto node = manager.compile(formula);
+    for (auto &&assignment : assignments(1000)) {
+      ASSERT_EQ(manager.evaluate(node, assignment),
+                formula.evaluate(assignment))
+          << text;
+    }
+  }
+}
+
+TEST_F(BddTest, SatCount) {
+  auto all = std::ldexp(1.0, BddManager::ATOMS);
+  EXPECT_EQ(manager.satCount(compile("a")), all / 2);
+  EXPECT_EQ(manager.satCount(compile("a and b")), all / 4);
+  EXPECT_EQ(manager.satCount(compile("a or b")), all * 3 / 4);
+  EXPECT_EQ(manager.satCount(compile("a in b")), all / 2);
+  EXPECT_EQ(manager.satCount(compile("a in a")), all / 2);
+  EXPECT_EQ(manager.satCount(compile("a and not a")), 0);
+  EXPECT_EQ(manager.satCount(compile("a or not a")), all);
+}
+
+TEST_F(BddTest, VariableOrder) {
+  auto text = "(a and b) or (c and d) or (e and f)";
+  auto interleaved = "(a and d) or (b and e) or (c and f)";
+  BddManager other("adbecf");
+
+  auto node = compile(text);
+  auto otherNode = other.compile(Formula(text));
+  for (auto &&assignment : assignments(1000)) {
+    ASSERT_EQ(manager.evaluate(node, assignment),
+              other.evaluate(otherNode, assignment));
+  }
+  EXPECT_EQ(manager.satCount(node), other.satCount(otherNode));
+  EXPECT_LT(manager.size(), other.size());
+
+  // The other order suits the interleaved pairs.
+  BddManager fresh;
+  fresh.compile(Formula(interleaved));
+  BddManager otherFresh("adbecf");
+  otherFresh.compile(Formula(interleaved));
+  EXPECT_LT(otherFresh.size(), fresh.size());
+}
+
+TEST_F(BddTest, InvalidOrder) {
+  EXPECT_THROW(BddManager("aba"), std::invalid_argument);
+  EXPECT_THROW(BddManager("aB"), std::invalid_argument);
+  EXPECT_NO_THROW(BddManager("zyx"));
+}
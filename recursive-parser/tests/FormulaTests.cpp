@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <AnalysisExcpetion.h>
+#include <Formula.h>
+
+#include <random>
+#include <type_traits>
+
+class FormulaTest : public ::testing::Test {
+protected:
+  static std::vector<Assignment> assignments(std::size_t count) {
+    std::mt19937 random(42);
+    std::vector<Assignment> result;
+    for (std::size_t i = 0; i < count; ++i) {
+      result.push_back({static_cast<std::uint32_t>(random()),
+                        static_cast<std::uint32_t>(random()),
+                        static_cast<std::uint32_t>(random())});
+    }
+    return result;
+  }
+
+  template <FixedString Text> static void expectSameAsRuntime() {
+    Formula formula(Text.view());
+    for (auto &&assignment : assignments(1000)) {
+      ASSERT_EQ(StaticFormula<Text>::evaluate(assignment),
+                formula.evaluate(assignment))
+          << Text.view();
+    }
+  }
+
+  static bool equivalent(std::string_view left, std::string_view right) {
+    Formula a(left), b(right);
+    for (auto &&assignment : assignments(1000)) {
+      if (a.evaluate(assignment) != b.evaluate(assignment)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+TEST_F(FormulaTest, StaticTypes) {
+  EXPECT_TRUE((std::is_same_v<StaticFormula<"a">, Var<'a'>>));
+  EXPECT_TRUE(
+      (std::is_same_v<StaticFormula<"not not (a)">, Not<Not<Var<'a'>>>>));
+  EXPECT_TRUE((std::is_same_v<StaticFormula<"a or b and c">,
+                              Or<Var<'a'>, And<Var<'b'>, Var<'c'>>>>));
+  EXPECT_TRUE((std::is_same_v<StaticFormula<"a xor b xor c">,
+                              Xor<Xor<Var<'a'>, Var<'b'>>, Var<'c'>>>));
+  EXPECT_TRUE((std::is_same_v<StaticFormula<"(a or b) not in c">,
+                              In<Or<Var<'a'>, Var<'b'>>, 'c', true>>));
+  EXPECT_TRUE(
+      (std::is_same_v<StaticFormula<"a in b not in c">,
+                      And<In<Var<'a'>, 'b'>, In<Var<'b'>, 'c', true>>>));
+}
+
+TEST_F(FormulaTest, ConstantEvaluation) {
+  static_assert(StaticFormula<"a and not b">::evaluate({0b01, 0, 0}));
+  static_assert(!StaticFormula<"a and not b">::evaluate({0b11, 0, 0}));
+  static_assert(StaticFormula<"a in b">::evaluate({0b01, 0, 0b10}));
+  static_assert(!StaticFormula<"a in b">::evaluate({0b01, 0b10, 0}));
+
+  constexpr auto tree = [] {
+    StringSyntaxAnalyzer analyzer{
+        LexicalAnalyzer<StringSource>{StringSource{"a or (b)"}}};
+    auto ast = analyzer.parse();
+    return ast.children.size() == 2 && ast.children[1].data == "E'";
+  }();
+  EXPECT_TRUE(tree);
+}
+
+TEST_F(FormulaTest, Operators) {
+  Assignment assignment{0b0011, 0b0100, 0b1000};
+  EXPECT_TRUE(Formula("a and b").evaluate(assignment));
+  EXPECT_FALSE(Formula("a and c").evaluate(assignment));
+  EXPECT_TRUE(Formula("c or a").evaluate(assignment));
+  EXPECT_FALSE(Formula("a xor b").evaluate(assignment));
+  EXPECT_TRUE(Formula("not c").evaluate(assignment));
+  EXPECT_TRUE(Formula("a in d").evaluate(assignment));
+  EXPECT_TRUE(Formula("c in c").evaluate(assignment));
+  EXPECT_TRUE(Formula("a not in c").evaluate(assignment));
+}
+
+TEST_F(FormulaTest, Precedence) {
+  EXPECT_TRUE(equivalent("a or b xor c and d", "a or (b xor (c and d))"));
+  EXPECT_TRUE(equivalent("not a in b", "not (a in b)"));
+  EXPECT_TRUE(equivalent("a and b in c", "a and (b in c)"));
+  EXPECT_FALSE(equivalent("a or b and c", "(a or b) and c"));
+}
+
+TEST_F(FormulaTest, ChainedMembership) {
+  EXPECT_TRUE(equivalent("a in b in c", "(a in b) and (b in c)"));
+  EXPECT_TRUE(equivalent("(a or b) not in c in d",
+                         "((a or b) not in c) and (c in d)"));
+  EXPECT_FALSE(equivalent("a in b in c", "(a in b) in c"));
+}
+
+TEST_F(FormulaTest, SameAsRuntime) {
+  expectSameAsRuntime<"a">();
+  expectSameAsRuntime<"not a xor b or c and d">();
+  expectSameAsRuntime<"(a or b) and not (c xor d) or e in f not in g">();
+  expectSameAsRuntime<"((a in b) or (c not in d)) xor not not (e and f)">();
+}
+
+TEST_F(FormulaTest, InvalidFormula) {
+  EXPECT_THROW(Formula("a and"), AnalysisException);
+  EXPECT_THROW(Formula("a in (b)"), AnalysisException);
+  EXPECT_THROW(Formula("A"), AnalysisException);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <AnalysisExcpetion.h>
+#include <LexicalAnalyzer.h>
+#include <ParallelLexer.h>
+
+#include <functional>
+#include <random>
+#include <string>
+
+class ParallelLexerTest : public ::testing::Test {
+protected:
+  // Formula large enough to be split, with parentheses glued to operators.
+  static std::string generate(std::size_t size, std::uint64_t seed = 42) {
+    std::mt19937_64 random(seed);
+    std::string formula;
+    while (formula.size() < size) {
+      formula += formula.empty() ? "" : random() % 2 ? " or\t" : ")or(";
+      formula += random() % 2 ? "not " : "";
+      formula += static_cast<char>('a' + random() % 26);
+      formula += random() % 2 ? " and (b)" : " xor\n(c in d)";
+    }
+    return "(" + formula + ")";
+  }
+
+  // Reference tokens collected from the lexer itself.
+  static Tokens serial(const std::string &text) {
+    LexicalAnalyzer<StringSource> lexer(StringSource{text});
+    Tokens tokens;
+    do {
+      tokens.push_back({lexer.nextToken(), lexer.pos()});
+    } while (tokens.back().token != Token::END);
+    return tokens;
+  }
+
+  static std::string errorMessage(const std::function<void()> &lex) {
+    try {
+      lex();
+    } catch (const AnalysisException &e) {
+      return e.what();
+    }
+    return "no error";
+  }
+};
+
+TEST_F(ParallelLexerTest, Serial) {
+  for (std::string text : {"", "  ", "a", "(a)", "not a in b", "a\tor(b) "}) {
+    EXPECT_EQ(tokenize(text), serial(text)) << text;
+  }
+}
+
+TEST_F(ParallelLexerTest, SmallInputIsNotSplit) {
+  auto text = generate(1000);
+  EXPECT_EQ(tokenizeParallel(text, 8), serial(text));
+}
+
+TEST_F(ParallelLexerTest, SameAsSerial) {
+  auto text = generate(2 * 1024 * 1024);
+  auto expected = serial(text);
+  for (std::size_t jobs : {1, 2, 3, 7, 16}) {
+    EXPECT_EQ(tokenizeParallel(text, jobs), expected) << jobs << " jobs";
+  }
+}
+
+TEST_F(ParallelLexerTest, ParenthesesOnly) {
+  std::string text(512 * 1024, '(');
+  text += 'a';
+  text += std::string(512 * 1024, ')');
+  EXPECT_EQ(tokenizeParallel(text, 4), serial(text));
+}
+
+TEST_F(ParallelLexerTest, NoBoundaries) {
+  std::string text(1024 * 1024, 'a');
+  auto expected = errorMessage([&] { serial(text); });
+  EXPECT_EQ(errorMessage([&] { tokenizeParallel(text, 4); }), expected);
+}
+
+TEST_F(ParallelLexerTest, FirstErrorIsReported) {
+  auto text = generate(2 * 1024 * 1024);
+  text[text.size() / 3] = '@';
+  text[text.size() / 3 + 1] = '@';
+  text[text.size() / 2] = 'x';
+  text[text.size() / 2 + 1] = 'x';
+
+  auto expected = errorMessage([&] { serial(text); });
+  ASSERT_NE(expected, "no error");
+  for (std::size_t jobs : {2, 4, 16}) {
+    EXPECT_EQ(errorMessage([&] { tokenizeParallel(text, jobs); }), expected)
+        << jobs << " jobs";
+  }
+}
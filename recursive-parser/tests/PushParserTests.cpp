@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+
+#include <AnalysisExcpetion.h>
+#include <PushSyntaxAnalyzer.h>
+#include <SyntaxAnalyzer.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <random>
+#include <string>
+#include <vector>
+
+class PushParserTest : public ::testing::Test {
+protected:
+  // Writes events in the form of `E(X(... a ...)E'())`.
+  struct Printer {
+    void enter(Nonterminal nonterminal) {
+      out += name(nonterminal);
+      out += '(';
+    }
+    void token(Token token, char variable) {
+      out += token == Token::VARIABLE ? variable : '#';
+    }
+    void exit(Nonterminal) { out += ')'; }
+
+    std::string out;
+  };
+
+  // Events followed by the error message if parsing failed.
+  static std::string serial(std::string_view input) {
+    Printer printer;
+    try {
+      SyntaxAnalyzer<StringViewSource> analyzer{
+          LexicalAnalyzer<StringViewSource>{StringViewSource{input}}};
+      analyzer.parse(printer);
+    } catch (const AnalysisException &e) {
+      printer.out += e.what();
+    }
+    return printer.out;
+  }
+
+  // Same as `serial` with input fed in chunks ending at `splits`.
+  static std::string pushed(std::string_view input,
+                            const std::vector<std::size_t> &splits) {
+    PushSyntaxAnalyzer<Printer> analyzer;
+    try {
+      std::size_t begin = 0;
+      for (auto end : splits) {
+        analyzer.feed(input.substr(begin, end - begin));
+        begin = end;
+      }
+      analyzer.feed(input.substr(begin));
+      EXPECT_EQ(analyzer.finish(), PushStatus::DONE);
+    } catch (const AnalysisException &e) {
+      analyzer.visitor().out += e.what();
+    }
+    return analyzer.visitor().out;
+  }
+
+  static void expectSameAsSerial(std::string_view input) {
+    auto expected = serial(input);
+    EXPECT_EQ(pushed(input, {}), expected) << input;
+    std::vector<std::size_t> bytes;
+    for (std::size_t i = 1; i < input.size(); ++i) {
+      EXPECT_EQ(pushed(input, {i}), expected) << input << " split at " << i;
+      bytes.push_back(i);
+    }
+    EXPECT_EQ(pushed(input, bytes), expected) << input << " byte by byte";
+  }
+
+  static std::string print(const NameASTNode &node) {
+    std::string out = node.data + '(';
+    for (auto &&child : node.children) {
+      out += print(child);
+    }
+    return out + ')';
+  }
+};
+
+TEST_F(PushParserTest, SameEventsForAnyChunks) {
+  for (auto input :
+       {"a", " not\ta ", "(a)or(b)", "a or b xor c and d",
+        "not (a in b) not in c in d", "((a)) and\n(not not b or c)",
+        "(a or b)in c", "x and y or not z xor (u)"}) {
+    expectSameAsSerial(input);
+  }
+}
+
+TEST_F(PushParserTest, SameErrorsForAnyChunks) {
+  for (auto input : {"", "   ", "a and", "a b", "(a", "a)", "a in (b)",
+                     "a not b", "ab", "a andb", "aor b", "A", "a or 1",
+                     "not", "(a) an"}) {
+    expectSameAsSerial(input);
+  }
+}
+
+TEST_F(PushParserTest, NeedsMoreInput) {
+  PushSyntaxAnalyzer<> analyzer;
+  EXPECT_EQ(analyzer.feed("a an"), PushStatus::NEED_MORE_INPUT);
+  EXPECT_EQ(analyzer.feed("d "), PushStatus::NEED_MORE_INPUT);
+  EXPECT_EQ(analyzer.feed("(b)"), PushStatus::NEED_MORE_INPUT);
+  EXPECT_EQ(analyzer.finish(), PushStatus::DONE);
+
+  auto expected = StringSyntaxAnalyzer{
+      LexicalAnalyzer<StringSource>{StringSource{"a and (b)"}}}.parse();
+  EXPECT_EQ(print(std::move(analyzer).result()), print(expected));
+}
+
+TEST_F(PushParserTest, ErrorBeforeEndOfInput) {
+  PushSyntaxAnalyzer<> analyzer;
+  EXPECT_EQ(analyzer.feed("a and ("), PushStatus::NEED_MORE_INPUT);
+  EXPECT_THROW(analyzer.feed("or b and c"), AnalysisException);
+}
+
+TEST_F(PushParserTest, DeepNestingWithoutRecursion) {
+  constexpr std::size_t depth = 100000;
+  PushSyntaxAnalyzer<Recognizer> analyzer;
+  for (std::size_t i = 0; i < depth; ++i) {
+    ASSERT_EQ(analyzer.feed("(not "), PushStatus::NEED_MORE_INPUT);
+  }
+  analyzer.feed("a");
+  for (std::size_t i = 0; i < depth; ++i) {
+    ASSERT_EQ(analyzer.feed(")"), PushStatus::NEED_MORE_INPUT);
+  }
+  EXPECT_EQ(analyzer.finish(), PushStatus::DONE);
+}
+
+// Single thread serving many connections through `poll`, the peers write
+// their formulas in small pieces.
+TEST_F(PushParserTest, SocketEventLoop) {
+  constexpr std::size_t connections = 1000;
+  std::mt19937 random(42);
+  auto formula = [&](std::size_t i) {
+    std::string text;
+    for (std::size_t clause = 0; clause < 1 + i % 20; ++clause) {
+      text += clause == 0 ? "(" : random() % 2 ? " or (" : "xor(";
+      text += static_cast<char>('a' + random() % 26);
+      text += random() % 2 ? " and not b)" : " not in c)";
+    }
+    // Every tenth one is invalid.
+    return i % 10 == 0 ? text + " and" : text;
+  };
+
+  struct Connection {
+    int client;
+    int server;
+    std::string input;
+    std::size_t written{};
+    PushSyntaxAnalyzer<Printer> analyzer;
+    std::string result;
+    bool done{};
+  };
+  std::vector<Connection> peers(connections);
+  for (std::size_t i = 0; i < connections; ++i) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    ASSERT_EQ(fcntl(fds[1], F_SETFL, O_NONBLOCK), 0);
+    peers[i].client = fds[0];
+    peers[i].server = fds[1];
+    peers[i].input = formula(i);
+  }
+
+  std::size_t finished = 0;
+  bool writing = true;
+  std::vector<pollfd> fds;
+  std::vector<std::size_t> polled;
+  char buffer[4096];
+  while (finished < connections) {
+    if (writing) {
+      writing = false;
+      for (auto &&peer : peers) {
+        if (peer.written == peer.input.size()) {
+          continue;
+        }
+        auto size = std::min<std::size_t>(1 + random() % 7,
+                                           peer.input.size() - peer.written);
+        ASSERT_EQ(write(peer.client, peer.input.data() + peer.written, size),
+                  static_cast<ssize_t>(size));
+        peer.written += size;
+        if (peer.written == peer.input.size()) {
+          shutdown(peer.client, SHUT_WR);
+        } else {
+          writing = true;
+        }
+      }
+    }
+
+    fds.clear();
+    polled.clear();
+    for (std::size_t i = 0; i < connections; ++i) {
+      if (!peers[i].done) {
+        fds.push_back({peers[i].server, POLLIN, 0});
+        polled.push_back(i);
+      }
+    }
+    ASSERT_GT(poll(fds.data(), fds.size(), writing ? 0 : -1), -1);
+
+    for (std::size_t i = 0; i < fds.size(); ++i) {
+      if (!fds[i].revents) {
+        continue;
+      }
+      auto &&peer = peers[polled[i]];
+      try {
+        ssize_t size;
+        while ((size = read(peer.server, buffer, sizeof(buffer))) > 0) {
+          peer.analyzer.feed({buffer, static_cast<std::size_t>(size)});
+        }
+        if (size == 0) {
+          peer.analyzer.finish();
+          peer.done = true;
+        } else {
+          ASSERT_EQ(errno, EAGAIN);
+        }
+      } catch (const AnalysisException &e) {
+        peer.result = e.what();
+        peer.done = true;
+      }
+      if (peer.done) {
+        peer.result = peer.analyzer.visitor().out + peer.result;
+        ++finished;
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < connections; ++i) {
+    auto &&peer = peers[i];
+    close(peer.client);
+    close(peer.server);
+    EXPECT_EQ(peer.result, serial(peer.input)) << peer.input;
+    EXPECT_EQ(peer.result.find("SyntaxException") != std::string::npos,
+              i % 10 == 0)
+        << peer.input;
+  }
+}
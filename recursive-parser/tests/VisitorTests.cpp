@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <AnalysisExcpetion.h>
+#include <SyntaxAnalyzer.h>
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::size_t allocations = 0;
+
+} // namespace
+
+// Not inlined, so that GCC does not take `free` for a mismatched `delete`.
+[[gnu::noinline]] void *operator new(std::size_t size) {
+  ++allocations;
+  if (auto memory = std::malloc(size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void *memory) noexcept {
+  std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+class VisitorTest : public ::testing::Test {
+protected:
+  static SyntaxAnalyzer<StringViewSource> analyzer(std::string_view input) {
+    return {LexicalAnalyzer<StringViewSource>{StringViewSource{input}}};
+  }
+
+  // Writes events in the form of `E(X(... a ...)E'())`.
+  struct Printer {
+    void enter(Nonterminal nonterminal) {
+      out += name(nonterminal);
+      out += '(';
+    }
+    void token(Token token, char variable) {
+      out += token == Token::VARIABLE ? variable : '#';
+    }
+    void exit(Nonterminal) { out += ')'; }
+
+    std::string out;
+  };
+
+  static std::string print(const NameASTNode &node) {
+    std::string out = node.data + '(';
+    for (auto &&child : node.children) {
+      out += print(child);
+    }
+    return out + ')';
+  }
+};
+
+TEST_F(VisitorTest, AllEvents) {
+  Printer printer;
+  analyzer("not a").parse(printer);
+  EXPECT_EQ(printer.out, "E(X(T(N(#N(M(F(a)M'())))T'())X'())E'())");
+}
+
+TEST_F(VisitorTest, TokensOnly) {
+  struct {
+    void token(Token token, char) { tokens.push_back(token); }
+    std::vector<Token> tokens;
+  } visitor;
+  analyzer("(a) not in b").parse(visitor);
+  EXPECT_EQ(visitor.tokens,
+            (std::vector{Token::LP, Token::VARIABLE, Token::RP,
+                         Token::NOT_OPERATOR, Token::IN_OPERATOR,
+                         Token::VARIABLE}));
+}
+
+TEST_F(VisitorTest, ExitsOnly) {
+  struct {
+    void exit(Nonterminal nonterminal) {
+      nested += nonterminal == Nonterminal::F;
+    }
+    std::size_t nested{};
+  } visitor;
+  analyzer("((a) or b) and c").parse(visitor);
+  EXPECT_EQ(visitor.nested, 5);
+}
+
+TEST_F(VisitorTest, SameTreeAsEvents) {
+  for (auto input : {"a", "a or b and not c", "(a xor b) in c not in d"}) {
+    Printer printer;
+    analyzer(input).parse(printer);
+    auto tree = print(analyzer(input).parse());
+
+    std::string withoutTokens;
+    for (auto ch : printer.out) {
+      if (ch != '#' && !('a' <= ch && ch <= 'z')) {
+        withoutTokens += ch;
+      }
+    }
+    EXPECT_EQ(tree, withoutTokens) << input;
+  }
+}
+
+TEST_F(VisitorTest, ValidateDoesNotAllocate) {
+  std::string input = "(a and not b) or (c xor d) in e not in f or not g";
+  for (int i = 0; i < 10; ++i) {
+    input = "(" + input + ") or " + input;
+  }
+  auto checked = analyzer(input);
+
+  auto before = allocations;
+  checked.validate();
+  EXPECT_EQ(allocations, before);
+
+  analyzer(input).parse();
+  EXPECT_GT(allocations, before);
+}
+
+TEST_F(VisitorTest, ValidateErrors) {
+  EXPECT_NO_THROW(analyzer("a in b").validate());
+  EXPECT_THROW(analyzer("a in").validate(), AnalysisException);
+  EXPECT_THROW(analyzer("(a").validate(), AnalysisException);
+  EXPECT_THROW(analyzer("a b").validate(), AnalysisException);
+}